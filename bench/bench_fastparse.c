@@ -0,0 +1,554 @@
+/*
+ * fastparse kernel benchmarks: GB/s per kernel over generated corpora
+ * (wide CSV, numeric CSV, escaped CSV, nested JSON, string-heavy JSON).
+ *
+ *   gcc -O3 -I. bench/bench_fastparse.c -o bench_fastparse -pthread
+ *   ./bench_fastparse [--size MB] [--counters] [--json FILE] [--csv FILE] [filter]
+ *
+ * --counters needs -DTIMER_ENABLE_PERF_COUNTERS (Linux) and prints cycles,
+ * instructions and misses per KB of input for each kernel.
+ */
+
+#include "fastparse.h"
+#include "timer.h"
+
+#define BENCH_MAX 32
+
+typedef struct {
+    char *data;
+    size_t len;
+} corpus_t;
+
+typedef struct {
+    const char *name;
+    const corpus_t *corpus;
+    size_t consumed;            /* bytes the last call got through */
+    size_t rows;                /* csv_row / csv_parallel: records seen, for the cross-check */
+    fp_json_index_t index;      /* json_skip_indexed only */
+    fp_arena_t arena;           /* row / decoded string kernels */
+} bench_ctx_t;
+
+/* ============================================================================
+ * Corpora (deterministic, so runs compare)
+ * ============================================================================ */
+
+static uint64_t g_rng = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t rng_next(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+static uint64_t rng_below(uint64_t n) {
+    return rng_next() % n;
+}
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+} buf_t;
+
+static void buf_put(buf_t *b, const char *s, size_t n) {
+    if (b->len + n + 1 > b->cap) {
+        b->cap = (b->cap + n + 1) * 2;
+        b->data = (char *)realloc(b->data, b->cap);
+        if (!b->data) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+    b->data[b->len] = '\0';
+}
+
+static void buf_puts(buf_t *b, const char *s) {
+    buf_put(b, s, strlen(s));
+}
+
+static void buf_word(buf_t *b, size_t min, size_t max) {
+    char word[64];
+    size_t n = min + (size_t)rng_below(max - min + 1);
+    for (size_t i = 0; i < n; i++) word[i] = (char)('a' + rng_below(26));
+    buf_put(b, word, n);
+}
+
+static corpus_t corpus_done(buf_t *b) {
+    corpus_t c = {b->data, b->len};
+    return c;
+}
+
+/* 256 columns: words, quoted text with commas, ints, decimals */
+static corpus_t make_wide_csv(size_t size) {
+    buf_t b = {0};
+    char num[32];
+    while (b.len < size) {
+        for (int col = 0; col < 256; col++) {
+            if (col) buf_put(&b, ",", 1);
+            switch (col % 4) {
+                case 0: buf_word(&b, 3, 12); break;
+                case 1:
+                    buf_put(&b, "\"", 1);
+                    buf_word(&b, 2, 8);
+                    buf_put(&b, ", ", 2);
+                    buf_word(&b, 2, 8);
+                    buf_put(&b, "\"", 1);
+                    break;
+                case 2:
+                    snprintf(num, sizeof(num), "%lld", (long long)rng_below(1000000));
+                    buf_puts(&b, num);
+                    break;
+                default:
+                    snprintf(num, sizeof(num), "%.3f", (double)rng_below(1000000) / 7.0);
+                    buf_puts(&b, num);
+                    break;
+            }
+        }
+        buf_put(&b, "\n", 1);
+    }
+    return corpus_done(&b);
+}
+
+/* Quoted fields with \" escapes, commas and newlines inside: the hard case for
+ * finding record boundaries without parsing */
+static corpus_t make_escaped_csv(size_t size) {
+    buf_t b = {0};
+    char num[32];
+    while (b.len < size) {
+        snprintf(num, sizeof(num), "%lld,", (long long)rng_below(1000000));
+        buf_puts(&b, num);
+        buf_put(&b, "\"", 1);
+        int parts = 1 + (int)rng_below(4);
+        for (int i = 0; i < parts; i++) {
+            buf_word(&b, 2, 10);
+            switch (rng_below(4)) {
+                case 0: buf_put(&b, "\\\"", 2); break;
+                case 1: buf_put(&b, ", ", 2); break;
+                case 2: buf_put(&b, "\n", 1); break;
+                default: buf_put(&b, "\\\\", 2); break;
+            }
+        }
+        buf_put(&b, "\",", 2);
+        buf_word(&b, 3, 8);
+        buf_put(&b, "\n", 1);
+    }
+    return corpus_done(&b);
+}
+
+/* 16 integer columns, mixed widths and signs */
+static corpus_t make_int_csv(size_t size) {
+    buf_t b = {0};
+    char num[32];
+    while (b.len < size) {
+        for (int col = 0; col < 16; col++) {
+            uint64_t digits = 1 + rng_below(18);
+            uint64_t limit = 1;
+            for (uint64_t i = 0; i < digits; i++) limit *= 10;
+            snprintf(num, sizeof(num), "%s%llu", rng_below(4) ? "" : "-", (unsigned long long)rng_below(limit));
+            buf_puts(&b, num);
+            buf_put(&b, col == 15 ? "\n" : ",", 1);
+        }
+    }
+    return corpus_done(&b);
+}
+
+/* 16 double columns: fixed, short and exponent forms */
+static corpus_t make_double_csv(size_t size) {
+    buf_t b = {0};
+    char num[48];
+    while (b.len < size) {
+        for (int col = 0; col < 16; col++) {
+            double v = (double)rng_next() / 18446744073709551616.0 * 2000.0 - 1000.0;
+            switch (rng_below(3)) {
+                case 0: snprintf(num, sizeof(num), "%.17g", v); break;
+                case 1: snprintf(num, sizeof(num), "%.4f", v); break;
+                default: snprintf(num, sizeof(num), "%.6e", v * 1e-12); break;
+            }
+            buf_puts(&b, num);
+            buf_put(&b, col == 15 ? "\n" : ",", 1);
+        }
+    }
+    return corpus_done(&b);
+}
+
+static void json_value(buf_t *b, int depth, int indent);
+
+static void json_indent(buf_t *b, int indent) {
+    static const char spaces[] = "                                                                ";
+    buf_put(b, "\n", 1);
+    buf_put(b, spaces, (size_t)(indent * 2 < 64 ? indent * 2 : 64));
+}
+
+static void json_object(buf_t *b, int depth, int indent) {
+    int fields = 2 + (int)rng_below(6);
+    buf_put(b, "{", 1);
+    for (int i = 0; i < fields; i++) {
+        if (i) buf_put(b, ",", 1);
+        json_indent(b, indent + 1);
+        buf_put(b, "\"", 1);
+        buf_word(b, 3, 10);
+        buf_put(b, "\": ", 3);
+        json_value(b, depth + 1, indent + 1);
+    }
+    json_indent(b, indent);
+    buf_put(b, "}", 1);
+}
+
+static void json_value(buf_t *b, int depth, int indent) {
+    char num[32];
+    uint64_t kind = depth >= 6 ? 2 + rng_below(4) : rng_below(6);
+    switch (kind) {
+        case 0: json_object(b, depth, indent); break;
+        case 1: {
+            int items = 1 + (int)rng_below(5);
+            buf_put(b, "[", 1);
+            for (int i = 0; i < items; i++) {
+                if (i) buf_put(b, ", ", 2);
+                json_value(b, depth + 1, indent);
+            }
+            buf_put(b, "]", 1);
+            break;
+        }
+        case 2:
+            buf_put(b, "\"", 1);
+            buf_word(b, 4, 24);
+            buf_put(b, "\"", 1);
+            break;
+        case 3:
+            snprintf(num, sizeof(num), "%.6g", (double)rng_below(10000000) / 1000.0);
+            buf_puts(b, num);
+            break;
+        case 4: buf_puts(b, rng_below(2) ? "true" : "false"); break;
+        default: buf_puts(b, "null"); break;
+    }
+}
+
+/* Pretty-printed array of nested objects */
+static corpus_t make_nested_json(size_t size) {
+    buf_t b = {0};
+    buf_put(&b, "[", 1);
+    while (b.len < size) {
+        if (b.len > 1) buf_put(&b, ",", 1);
+        json_indent(&b, 1);
+        json_object(&b, 0, 1);
+    }
+    buf_puts(&b, "\n]\n");
+    return corpus_done(&b);
+}
+
+/* Flat array of long strings, some with escapes */
+static corpus_t make_string_json(size_t size) {
+    static const char *escapes[] = {"\\n", "\\\"", "\\\\", "\\u00e9", "\\ud83d\\ude00", "\\t"};
+    buf_t b = {0};
+    buf_put(&b, "[", 1);
+    while (b.len < size) {
+        if (b.len > 1) buf_put(&b, ",", 1);
+        buf_put(&b, "\"", 1);
+        int words = 2 + (int)rng_below(20);
+        for (int i = 0; i < words; i++) {
+            if (i) buf_put(&b, " ", 1);
+            buf_word(&b, 2, 12);
+            if (rng_below(16) == 0) buf_puts(&b, escapes[rng_below(6)]);
+        }
+        buf_put(&b, "\"", 1);
+    }
+    buf_puts(&b, "]\n");
+    return corpus_done(&b);
+}
+
+/* ============================================================================
+ * Kernels
+ * ============================================================================ */
+
+static void bench_skip_ws(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    while (!fp_at_end(&p)) {
+        fp_skip_ws(&p);
+        fp_advance(&p);
+    }
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+}
+
+static void bench_int64(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    int64_t v;
+    while (fp_parse_int64(&p, &v)) {
+        BENCHMARK_DO_NOT_OPTIMIZE(v);
+        fp_advance(&p);     /* ',' or '\n' */
+    }
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+}
+
+static void bench_double(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    double v;
+    while (fp_parse_double(&p, &v)) {
+        BENCHMARK_DO_NOT_OPTIMIZE(v);
+        fp_advance(&p);
+    }
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+}
+
+static void bench_csv_line(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    fp_view_t fields[FP_CSV_MAX_FIELDS];
+    while (!fp_at_end(&p)) {
+        size_t count = fp_parse_csv_line(&p, fields);
+        BENCHMARK_DO_NOT_OPTIMIZE(count);
+        BENCHMARK_CLOBBER();
+    }
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+}
+
+static void csv_parallel_row(void *user, const fp_view_t *fields, size_t count, int thread) {
+    (void)user;
+    (void)thread;
+    BENCHMARK_DO_NOT_OPTIMIZE(fields[count - 1].len);
+}
+
+/* Small chunks, so plenty of boundaries land inside quoted fields */
+static void bench_csv_parallel(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_csv_parallel_options_t options = {0, 256u << 10, false};
+    ctx->rows = fp_parse_csv_parallel(ctx->corpus->data, ctx->corpus->len, &options, csv_parallel_row, NULL).rows;
+    ctx->consumed = ctx->corpus->len;
+}
+
+static void bench_csv_row(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    fp_arena_reset(&ctx->arena);
+    FP_CSV_ROW(row, &ctx->arena);
+    size_t rows = 0;
+    while (!fp_at_end(&p)) {
+        size_t count = fp_parse_csv_row(&p, &row);
+        BENCHMARK_DO_NOT_OPTIMIZE(count);
+        BENCHMARK_CLOBBER();
+        rows += count != 0;
+    }
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+    ctx->rows = rows;
+}
+
+static void bench_csv_field(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    fp_view_t field;
+    while (fp_parse_csv_field(&p, &field)) {
+        BENCHMARK_DO_NOT_OPTIMIZE(field.len);
+        if (!fp_match_char(&p, ',')) fp_match_char(&p, '\n');
+    }
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+}
+
+static void bench_json_skip(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    if (fp_skip_json_value(&p)) fp_skip_ws(&p);
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+}
+
+/* Stage 1 + stage 2: the index is rebuilt every call */
+static void bench_json_skip_indexed(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    ctx->consumed = 0;
+    if (!fp_json_index_build(&ctx->index, ctx->corpus->data, ctx->corpus->len)) return;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    if (fp_json_skip(&p, &ctx->index)) fp_skip_ws(&p);
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+    fp_json_index_free(&ctx->index);
+}
+
+static void bench_quoted_string(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    fp_view_t str;
+    fp_match_char(&p, '[');
+    while (fp_parse_quoted_string(&p, &str)) {
+        BENCHMARK_DO_NOT_OPTIMIZE(str.len);
+        if (!fp_match_char(&p, ',')) break;
+    }
+    fp_match_char(&p, ']');
+    fp_skip_ws(&p);
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+}
+
+static void bench_string_decoded(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    fp_parser_t p = fp_init(ctx->corpus->data, ctx->corpus->len);
+    fp_view_t str;
+    fp_match_char(&p, '[');
+    for (;;) {
+        fp_arena_reset(&ctx->arena);
+        if (!fp_parse_string_decoded(&p, &ctx->arena, &str)) break;
+        BENCHMARK_DO_NOT_OPTIMIZE(str.len);
+        if (!fp_match_char(&p, ',')) break;
+    }
+    fp_match_char(&p, ']');
+    fp_skip_ws(&p);
+    ctx->consumed = (size_t)(p.current - ctx->corpus->data);
+}
+
+typedef struct {
+    const char *name;
+    benchmark_fn_t fn;
+    int corpus;
+    benchmark_fn_t reference;   /* if set, must see as many records as fn */
+} bench_def_t;
+
+enum { WIDE_CSV, INT_CSV, DOUBLE_CSV, ESCAPED_CSV, NESTED_JSON, STRING_JSON, CORPUS_COUNT };
+
+static const char *g_corpus_names[CORPUS_COUNT] = {
+    "wide_csv", "int_csv", "double_csv", "escaped_csv", "nested_json", "string_json"
+};
+
+static const bench_def_t g_benches[] = {
+    {"skip_ws",           bench_skip_ws,           NESTED_JSON, NULL},
+    {"int64",             bench_int64,             INT_CSV,     NULL},
+    {"double",            bench_double,            DOUBLE_CSV,  NULL},
+    {"csv_line",          bench_csv_line,          INT_CSV,     NULL},
+    {"csv_line",          bench_csv_line,          DOUBLE_CSV,  NULL},
+    {"csv_line",          bench_csv_line,          ESCAPED_CSV, NULL},
+    {"csv_parallel",      bench_csv_parallel,      WIDE_CSV,    bench_csv_row},
+    {"csv_parallel",      bench_csv_parallel,      ESCAPED_CSV, bench_csv_row},
+    {"csv_field",         bench_csv_field,         WIDE_CSV,    NULL},
+    {"csv_row",           bench_csv_row,           WIDE_CSV,    NULL},
+    {"json_skip",         bench_json_skip,         NESTED_JSON, NULL},
+    {"json_skip",         bench_json_skip,         STRING_JSON, NULL},
+    {"json_skip_indexed", bench_json_skip_indexed, NESTED_JSON, NULL},
+    {"json_skip_indexed", bench_json_skip_indexed, STRING_JSON, NULL},
+    {"quoted_string",     bench_quoted_string,     STRING_JSON, NULL},
+    {"string_decoded",    bench_string_decoded,    STRING_JSON, NULL},
+};
+
+#define BENCH_COUNT (sizeof(g_benches) / sizeof(g_benches[0]))
+
+static const char *simd_name(fp_simd_level_t level) {
+    switch (level) {
+        case FP_SIMD_SSE2: return "sse2";
+        case FP_SIMD_NEON: return "neon";
+        case FP_SIMD_AVX2: return "avx2";
+        case FP_SIMD_AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+static int write_results(const char *path, const benchmark_result_t *results, int count, int json) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "can't write %s\n", path);
+        return 0;
+    }
+    if (json) benchmark_write_json(out, results, count);
+    else benchmark_write_csv(out, results, count);
+    return fclose(out) == 0;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--size MB] [--counters] [--json FILE] [--csv FILE] [filter]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    size_t size = 8u << 20;
+    int use_counters = 0;
+    const char *json_path = NULL, *csv_path = NULL, *filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            size = (size_t)strtoul(argv[++i], NULL, 10) << 20;
+        } else if (strcmp(argv[i], "--counters") == 0) {
+            use_counters = 1;
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            filter = argv[i];
+        }
+    }
+    if (size == 0) size = 1u << 20;
+
+    timer_clock_init();
+    printf("clock: %s, simd: %s, corpus size: %zu MB\n",
+           timer_clock_name(), simd_name(fp_simd_level()), size >> 20);
+
+    corpus_t corpora[CORPUS_COUNT];
+    corpora[WIDE_CSV] = make_wide_csv(size);
+    corpora[INT_CSV] = make_int_csv(size);
+    corpora[DOUBLE_CSV] = make_double_csv(size);
+    corpora[ESCAPED_CSV] = make_escaped_csv(size);
+    corpora[NESTED_JSON] = make_nested_json(size);
+    corpora[STRING_JSON] = make_string_json(size);
+
+    timer_counters_t counters;
+    if (use_counters && timer_counters_open(&counters) == 0) {
+        printf("counters: none available (perf_event_open refused or not built with TIMER_ENABLE_PERF_COUNTERS)\n");
+        use_counters = 0;
+    }
+
+    static char arena_buffer[1 << 16];
+    static char names[BENCH_MAX][64];
+    benchmark_result_t results[BENCH_MAX];
+    int result_count = 0;
+    int failed = 0;
+
+    for (size_t i = 0; i < BENCH_COUNT && result_count < BENCH_MAX; i++) {
+        const bench_def_t *def = &g_benches[i];
+        snprintf(names[result_count], sizeof(names[result_count]), "%s/%s", def->name, g_corpus_names[def->corpus]);
+        if (filter && !strstr(names[result_count], filter)) continue;
+
+        bench_ctx_t ctx;
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.name = names[result_count];
+        ctx.corpus = &corpora[def->corpus];
+        ctx.arena = fp_arena_init(arena_buffer, sizeof(arena_buffer));
+
+        /* A kernel that stops early would look fast; check it reads everything */
+        def->fn(&ctx);
+        if (ctx.consumed != ctx.corpus->len) {
+            fprintf(stderr, "%s: stopped at byte %zu of %zu\n", ctx.name, ctx.consumed, ctx.corpus->len);
+            failed = 1;
+            continue;
+        }
+        /* Parallel parsing has to find the same records as one sequential pass */
+        if (def->reference) {
+            bench_ctx_t ref = ctx;
+            def->reference(&ref);
+            if (ref.rows != ctx.rows) {
+                fprintf(stderr, "%s: %zu rows, sequential pass has %zu\n", ctx.name, ctx.rows, ref.rows);
+                failed = 1;
+                continue;
+            }
+        }
+
+        benchmark_config_t config = {0};
+        config.name = ctx.name;
+        config.bytes_per_call = ctx.corpus->len;
+        benchmark_result_t r = benchmark_run(&config, def->fn, &ctx);
+        benchmark_print(&r);
+        results[result_count++] = r;
+
+        if (use_counters) {
+            timer_counters_reset(&counters);
+            benchmark_count(def->fn, &ctx, r.iterations, &counters);
+            timer_counters_print(&counters, "  per KB", (double)r.iterations * (double)ctx.corpus->len / 1024.0, NULL);
+        }
+    }
+
+    if (json_path && !write_results(json_path, results, result_count, 1)) failed = 1;
+    if (csv_path && !write_results(csv_path, results, result_count, 0)) failed = 1;
+
+    if (use_counters) timer_counters_close(&counters);
+    for (int i = 0; i < CORPUS_COUNT; i++) free(corpora[i].data);
+    return failed;
+}
@@ -1,570 +1,3114 @@
-#ifndef ERROR_HANDLER_H
-#define ERROR_HANDLER_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/* Windows-specific includes */
-#ifdef _WIN32
-    #include <windows.h>
-    #include <dbghelp.h>
-    #include <excpt.h>
-    #include <signal.h>
-    #pragma comment(lib, "dbghelp.lib")
-#endif
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdarg.h>
-#include <string.h>
-#include <time.h>
-#include <errno.h>
-#include <assert.h>
-
-/* Configuration macros */
-#ifndef EH_MAX_ERROR_MSG_SIZE
-    #define EH_MAX_ERROR_MSG_SIZE 1024
-#endif
-
-#ifndef EH_MAX_STACK_FRAMES
-    #define EH_MAX_STACK_FRAMES 64
-#endif
-
-#ifndef EH_LOG_FILE_PATH
-    #define EH_LOG_FILE_PATH "error_log.txt"
-#endif
-
-/* Error severity levels */
-typedef enum {
-    EH_SEVERITY_INFO = 0,
-    EH_SEVERITY_WARNING,
-    EH_SEVERITY_ERROR,
-    EH_SEVERITY_CRITICAL,
-    EH_SEVERITY_PANIC
-} eh_severity_t;
-
-/* Error codes */
-typedef enum {
-    EH_SUCCESS = 0,
-    EH_ERROR_GENERIC = -1,
-    EH_ERROR_MEMORY = -2,
-    EH_ERROR_FILE_IO = -3,
-    EH_ERROR_INVALID_PARAM = -4,
-    EH_ERROR_NETWORK = -5,
-    EH_ERROR_TIMEOUT = -6,
-    EH_ERROR_ACCESS_DENIED = -7,
-    EH_ERROR_NOT_FOUND = -8,
-    EH_ERROR_ALREADY_EXISTS = -9,
-    EH_ERROR_CORRUPTED_DATA = -10,
-    EH_ERROR_SYSTEM_CALL = -999
-} eh_error_code_t;
-
-/* Error context structure */
-typedef struct {
-    eh_error_code_t code;
-    eh_severity_t severity;
-    char message[EH_MAX_ERROR_MSG_SIZE];
-    char function[128];
-    char file[256];
-    int line;
-    DWORD win32_error;
-    time_t timestamp;
-    int call_depth;
-} eh_error_context_t;
-
-/* Configuration structure */
-typedef struct {
-    int enable_logging;
-    int enable_console_output;
-    int enable_debug_output;
-    int enable_stack_trace;
-    int enable_crash_dumps;
-    int abort_on_panic;
-    char log_file_path[512];
-    FILE* log_file_handle;
-} eh_config_t;
-
-/* Global configuration */
-static eh_config_t g_eh_config = {
-    .enable_logging = 1,
-    .enable_console_output = 1,
-    .enable_debug_output = 1,
-    .enable_stack_trace = 1,
-    .enable_crash_dumps = 1,
-    .abort_on_panic = 1,
-    .log_file_path = EH_LOG_FILE_PATH,
-    .log_file_handle = NULL
-};
-
-/* Function pointer for custom error handlers */
-typedef void (*eh_custom_handler_t)(const eh_error_context_t* context);
-static eh_custom_handler_t g_custom_handler = NULL;
-
-/* Internal state tracking */
-static int g_eh_initialized = 0;
-static int g_error_count = 0;
-static int g_warning_count = 0;
-static eh_error_context_t g_last_error = {0};
-
-/* Forward declarations */
-static void eh_internal_log(const eh_error_context_t* context);
-static void eh_print_stack_trace(void);
-static const char* eh_severity_to_string(eh_severity_t severity);
-static const char* eh_error_code_to_string(eh_error_code_t code);
-static void eh_write_crash_dump(EXCEPTION_POINTERS* exception_pointers);
-static LONG WINAPI eh_unhandled_exception_filter(EXCEPTION_POINTERS* exception_pointers);
-
-/* Initialization and cleanup */
-static inline int eh_init(void) {
-    if (g_eh_initialized) return EH_SUCCESS;
-    
-#ifdef _WIN32
-    /* Initialize symbol handler for stack traces */
-    if (g_eh_config.enable_stack_trace) {
-        SymInitialize(GetCurrentProcess(), NULL, TRUE);
-        SymSetOptions(SYMOPT_LOAD_LINES | SYMOPT_UNDNAME);
-    }
-    
-    /* Set up unhandled exception filter */
-    SetUnhandledExceptionFilter(eh_unhandled_exception_filter);
-    
-    /* Set up console control handler for graceful shutdown */
-    SetConsoleCtrlHandler(NULL, FALSE);
-#endif
-    
-    /* Open log file if logging is enabled */
-    if (g_eh_config.enable_logging && !g_eh_config.log_file_handle) {
-        g_eh_config.log_file_handle = fopen(g_eh_config.log_file_path, "a");
-        if (g_eh_config.log_file_handle) {
-            fprintf(g_eh_config.log_file_handle, "\n=== Error Handler Initialized [%s] ===\n", 
-                   __TIMESTAMP__);
-            fflush(g_eh_config.log_file_handle);
-        }
-    }
-    
-    g_eh_initialized = 1;
-    return EH_SUCCESS;
-}
-
-static inline void eh_cleanup(void) {
-    if (!g_eh_initialized) return;
-    
-    if (g_eh_config.log_file_handle) {
-        fprintf(g_eh_config.log_file_handle, "=== Error Handler Shutdown ===\n");
-        fprintf(g_eh_config.log_file_handle, "Total Errors: %d, Warnings: %d\n", 
-               g_error_count, g_warning_count);
-        fclose(g_eh_config.log_file_handle);
-        g_eh_config.log_file_handle = NULL;
-    }
-    
-#ifdef _WIN32
-    if (g_eh_config.enable_stack_trace) {
-        SymCleanup(GetCurrentProcess());
-    }
-#endif
-    
-    g_eh_initialized = 0;
-}
-
-/* Configuration functions */
-static inline void eh_set_config(const eh_config_t* config) {
-    if (config) {
-        g_eh_config = *config;
-        if (g_eh_initialized && g_eh_config.enable_logging && !g_eh_config.log_file_handle) {
-            g_eh_config.log_file_handle = fopen(g_eh_config.log_file_path, "a");
-        }
-    }
-}
-
-static inline void eh_set_custom_handler(eh_custom_handler_t handler) {
-    g_custom_handler = handler;
-}
-
-/* Core error handling function */
-static inline void eh_handle_error_internal(eh_error_code_t code, eh_severity_t severity,
-                                          const char* function, const char* file, int line,
-                                          const char* format, va_list args) {
-    if (!g_eh_initialized) eh_init();
-    
-    eh_error_context_t context = {0};
-    context.code = code;
-    context.severity = severity;
-    context.line = line;
-    context.timestamp = time(NULL);
-    context.call_depth = 0; /* Could be enhanced with call stack analysis */
-    
-#ifdef _WIN32
-    context.win32_error = GetLastError();
-#endif
-    
-    /* Copy function and file names safely */
-    strncpy(context.function, function ? function : "unknown", sizeof(context.function) - 1);
-    strncpy(context.file, file ? file : "unknown", sizeof(context.file) - 1);
-    
-    /* Format the error message */
-    vsnprintf(context.message, sizeof(context.message), format, args);
-    
-    /* Update statistics */
-    if (severity >= EH_SEVERITY_ERROR) g_error_count++;
-    else if (severity == EH_SEVERITY_WARNING) g_warning_count++;
-    
-    /* Store as last error */
-    g_last_error = context;
-    
-    /* Call custom handler if set */
-    if (g_custom_handler) {
-        g_custom_handler(&context);
-    }
-    
-    /* Internal logging */
-    eh_internal_log(&context);
-    
-    /* Handle panic condition */
-    if (severity == EH_SEVERITY_PANIC) {
-        if (g_eh_config.enable_stack_trace) {
-            eh_print_stack_trace();
-        }
-        
-        if (g_eh_config.abort_on_panic) {
-            if (g_eh_config.enable_console_output) {
-                fprintf(stderr, "\n*** PANIC: Application will terminate ***\n");
-            }
-            eh_cleanup();
-            abort();
-        }
-    }
-}
-
-/* Variadic wrapper functions */
-static inline void eh_handle_error(eh_error_code_t code, eh_severity_t severity,
-                                 const char* function, const char* file, int line,
-                                 const char* format, ...) {
-    va_list args;
-    va_start(args, format);
-    eh_handle_error_internal(code, severity, function, file, line, format, args);
-    va_end(args);
-}
-
-/* Convenience macros */
-#define EH_INFO(code, ...) \
-    eh_handle_error(code, EH_SEVERITY_INFO, __FUNCTION__, __FILE__, __LINE__, __VA_ARGS__)
-
-#define EH_WARN(code, ...) \
-    eh_handle_error(code, EH_SEVERITY_WARNING, __FUNCTION__, __FILE__, __LINE__, __VA_ARGS__)
-
-#define EH_ERROR(code, ...) \
-    eh_handle_error(code, EH_SEVERITY_ERROR, __FUNCTION__, __FILE__, __LINE__, __VA_ARGS__)
-
-#define EH_CRITICAL(code, ...) \
-    eh_handle_error(code, EH_SEVERITY_CRITICAL, __FUNCTION__, __FILE__, __LINE__, __VA_ARGS__)
-
-#define EH_PANIC(...) \
-    eh_handle_error(EH_ERROR_GENERIC, EH_SEVERITY_PANIC, __FUNCTION__, __FILE__, __LINE__, __VA_ARGS__)
-
-/* Assertion macros with better error reporting */
-#define EH_ASSERT(condition, ...) \
-    do { \
-        if (!(condition)) { \
-            EH_PANIC("Assertion failed: " #condition ". " __VA_ARGS__); \
-        } \
-    } while(0)
-
-#define EH_ASSERT_NOT_NULL(ptr, ...) \
-    EH_ASSERT((ptr) != NULL, "Null pointer: " #ptr ". " __VA_ARGS__)
-
-/* Memory allocation with error handling */
-#define EH_MALLOC(size) eh_safe_malloc(size, __FUNCTION__, __FILE__, __LINE__)
-#define EH_CALLOC(count, size) eh_safe_calloc(count, size, __FUNCTION__, __FILE__, __LINE__)
-#define EH_REALLOC(ptr, size) eh_safe_realloc(ptr, size, __FUNCTION__, __FILE__, __LINE__)
-#define EH_FREE(ptr) eh_safe_free((void**)&(ptr))
-
-static inline void* eh_safe_malloc(size_t size, const char* function, const char* file, int line) {
-    void* ptr = malloc(size);
-    if (!ptr && size > 0) {
-        eh_handle_error(EH_ERROR_MEMORY, EH_SEVERITY_CRITICAL, function, file, line,
-                       "Memory allocation failed: %zu bytes", size);
-    }
-    return ptr;
-}
-
-static inline void* eh_safe_calloc(size_t count, size_t size, const char* function, const char* file, int line) {
-    void* ptr = calloc(count, size);
-    if (!ptr && count > 0 && size > 0) {
-        eh_handle_error(EH_ERROR_MEMORY, EH_SEVERITY_CRITICAL, function, file, line,
-                       "Memory allocation failed: %zu x %zu bytes", count, size);
-    }
-    return ptr;
-}
-
-static inline void* eh_safe_realloc(void* ptr, size_t size, const char* function, const char* file, int line) {
-    void* new_ptr = realloc(ptr, size);
-    if (!new_ptr && size > 0) {
-        eh_handle_error(EH_ERROR_MEMORY, EH_SEVERITY_CRITICAL, function, file, line,
-                       "Memory reallocation failed: %zu bytes", size);
-        return ptr; /* Return original pointer to avoid memory leak */
-    }
-    return new_ptr;
-}
-
-static inline void eh_safe_free(void** ptr) {
-    if (ptr && *ptr) {
-        free(*ptr);
-        *ptr = NULL;
-    }
-}
-
-/* File operations with error handling */
-static inline FILE* eh_safe_fopen(const char* filename, const char* mode, 
-                                 const char* function, const char* file, int line) {
-    FILE* fp = fopen(filename, mode);
-    if (!fp) {
-        eh_handle_error(EH_ERROR_FILE_IO, EH_SEVERITY_ERROR, function, file, line,
-                       "Failed to open file '%s' with mode '%s': %s", 
-                       filename, mode, strerror(errno));
-    }
-    return fp;
-}
-
-#define EH_FOPEN(filename, mode) eh_safe_fopen(filename, mode, __FUNCTION__, __FILE__, __LINE__)
-
-/* Windows-specific error handling */
-#ifdef _WIN32
-static inline void eh_handle_win32_error(const char* function, const char* file, int line,
-                                        const char* operation) {
-    DWORD error = GetLastError();
-    if (error != ERROR_SUCCESS) {
-        char* message = NULL;
-        FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM,
-                      NULL, error, 0, (LPSTR)&message, 0, NULL);
-        
-        eh_handle_error(EH_ERROR_SYSTEM_CALL, EH_SEVERITY_ERROR, function, file, line,
-                       "Win32 error in %s: %s (Code: %lu)", 
-                       operation, message ? message : "Unknown error", error);
-        
-        if (message) LocalFree(message);
-    }
-}
-
-#define EH_WIN32_CHECK(operation) \
-    eh_handle_win32_error(__FUNCTION__, __FILE__, __LINE__, #operation)
-#endif
-
-/* Utility functions */
-static inline const eh_error_context_t* eh_get_last_error(void) {
-    return &g_last_error;
-}
-
-static inline int eh_get_error_count(void) {
-    return g_error_count;
-}
-
-static inline int eh_get_warning_count(void) {
-    return g_warning_count;
-}
-
-/* Internal implementation functions */
-static void eh_internal_log(const eh_error_context_t* context) {
-    char timestamp_str[64];
-    struct tm* tm_info = localtime(&context->timestamp);
-    strftime(timestamp_str, sizeof(timestamp_str), "%Y-%m-%d %H:%M:%S", tm_info);
-    
-    const char* severity_str = eh_severity_to_string(context->severity);
-    const char* code_str = eh_error_code_to_string(context->code);
-    
-    char log_line[2048];
-    snprintf(log_line, sizeof(log_line),
-            "[%s] %s (%s) in %s() at %s:%d - %s",
-            timestamp_str, severity_str, code_str,
-            context->function, context->file, context->line, context->message);
-    
-#ifdef _WIN32
-    if (context->win32_error != 0) {
-        char win32_msg[512];
-        snprintf(win32_msg, sizeof(win32_msg), " [Win32: %lu]", context->win32_error);
-        strncat(log_line, win32_msg, sizeof(log_line) - strlen(log_line) - 1);
-    }
-#endif
-    
-    /* Console output */
-    if (g_eh_config.enable_console_output) {
-        FILE* output = (context->severity >= EH_SEVERITY_ERROR) ? stderr : stdout;
-        fprintf(output, "%s\n", log_line);
-        fflush(output);
-    }
-    
-    /* Debug output (Windows) */
-#ifdef _WIN32
-    if (g_eh_config.enable_debug_output && IsDebuggerPresent()) {
-        OutputDebugStringA(log_line);
-        OutputDebugStringA("\n");
-    }
-#endif
-    
-    /* File logging */
-    if (g_eh_config.enable_logging && g_eh_config.log_file_handle) {
-        fprintf(g_eh_config.log_file_handle, "%s\n", log_line);
-        fflush(g_eh_config.log_file_handle);
-    }
-}
-
-static void eh_print_stack_trace(void) {
-#ifdef _WIN32
-    if (!g_eh_config.enable_stack_trace) return;
-    
-    HANDLE process = GetCurrentProcess();
-    HANDLE thread = GetCurrentThread();
-    
-    CONTEXT context;
-    memset(&context, 0, sizeof(CONTEXT));
-    context.ContextFlags = CONTEXT_FULL;
-    RtlCaptureContext(&context);
-    
-    STACKFRAME64 stack_frame;
-    memset(&stack_frame, 0, sizeof(STACKFRAME64));
-    
-#ifdef _M_IX86
-    DWORD machine_type = IMAGE_FILE_MACHINE_I386;
-    stack_frame.AddrPC.Offset = context.Eip;
-    stack_frame.AddrPC.Mode = AddrModeFlat;
-    stack_frame.AddrFrame.Offset = context.Ebp;
-    stack_frame.AddrFrame.Mode = AddrModeFlat;
-    stack_frame.AddrStack.Offset = context.Esp;
-    stack_frame.AddrStack.Mode = AddrModeFlat;
-#elif _M_X64
-    DWORD machine_type = IMAGE_FILE_MACHINE_AMD64;
-    stack_frame.AddrPC.Offset = context.Rip;
-    stack_frame.AddrPC.Mode = AddrModeFlat;
-    stack_frame.AddrFrame.Offset = context.Rsp;
-    stack_frame.AddrFrame.Mode = AddrModeFlat;
-    stack_frame.AddrStack.Offset = context.Rsp;
-    stack_frame.AddrStack.Mode = AddrModeFlat;
-#endif
-    
-    if (g_eh_config.enable_console_output) {
-        fprintf(stderr, "\n=== Stack Trace ===\n");
-    }
-    
-    for (int frame_num = 0; frame_num < EH_MAX_STACK_FRAMES; frame_num++) {
-        if (!StackWalk64(machine_type, process, thread, &stack_frame, 
-                        &context, NULL, SymFunctionTableAccess64, 
-                        SymGetModuleBase64, NULL)) {
-            break;
-        }
-        
-        if (stack_frame.AddrPC.Offset == 0) break;
-        
-        char symbol_buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME * sizeof(TCHAR)];
-        PSYMBOL_INFO symbol = (PSYMBOL_INFO)symbol_buffer;
-        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
-        symbol->MaxNameLen = MAX_SYM_NAME;
-        
-        DWORD64 displacement = 0;
-        if (SymFromAddr(process, stack_frame.AddrPC.Offset, &displacement, symbol)) {
-            IMAGEHLP_LINE64 line;
-            DWORD line_displacement = 0;
-            line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
-            
-            if (SymGetLineFromAddr64(process, stack_frame.AddrPC.Offset, 
-                                   &line_displacement, &line)) {
-                if (g_eh_config.enable_console_output) {
-                    fprintf(stderr, "  #%d: %s() at %s:%lu (0x%016llX)\n",
-                           frame_num, symbol->Name, line.FileName, 
-                           line.LineNumber, stack_frame.AddrPC.Offset);
-                }
-            } else {
-                if (g_eh_config.enable_console_output) {
-                    fprintf(stderr, "  #%d: %s() (0x%016llX)\n",
-                           frame_num, symbol->Name, stack_frame.AddrPC.Offset);
-                }
-            }
-        } else {
-            if (g_eh_config.enable_console_output) {
-                fprintf(stderr, "  #%d: <unknown> (0x%016llX)\n",
-                       frame_num, stack_frame.AddrPC.Offset);
-            }
-        }
-    }
-    
-    if (g_eh_config.enable_console_output) {
-        fprintf(stderr, "===================\n\n");
-    }
-#endif
-}
-
-static const char* eh_severity_to_string(eh_severity_t severity) {
-    switch (severity) {
-        case EH_SEVERITY_INFO: return "INFO";
-        case EH_SEVERITY_WARNING: return "WARN";
-        case EH_SEVERITY_ERROR: return "ERROR";
-        case EH_SEVERITY_CRITICAL: return "CRITICAL";
-        case EH_SEVERITY_PANIC: return "PANIC";
-        default: return "UNKNOWN";
-    }
-}
-
-static const char* eh_error_code_to_string(eh_error_code_t code) {
-    switch (code) {
-        case EH_SUCCESS: return "SUCCESS";
-        case EH_ERROR_GENERIC: return "GENERIC";
-        case EH_ERROR_MEMORY: return "MEMORY";
-        case EH_ERROR_FILE_IO: return "FILE_IO";
-        case EH_ERROR_INVALID_PARAM: return "INVALID_PARAM";
-        case EH_ERROR_NETWORK: return "NETWORK";
-        case EH_ERROR_TIMEOUT: return "TIMEOUT";
-        case EH_ERROR_ACCESS_DENIED: return "ACCESS_DENIED";
-        case EH_ERROR_NOT_FOUND: return "NOT_FOUND";
-        case EH_ERROR_ALREADY_EXISTS: return "ALREADY_EXISTS";
-        case EH_ERROR_CORRUPTED_DATA: return "CORRUPTED_DATA";
-        case EH_ERROR_SYSTEM_CALL: return "SYSTEM_CALL";
-        default: return "UNKNOWN";
-    }
-}
-
-/* Windows crash dump generation */
-#ifdef _WIN32
-static void eh_write_crash_dump(EXCEPTION_POINTERS* exception_pointers) {
-    if (!g_eh_config.enable_crash_dumps) return;
-    
-    char dump_filename[512];
-    time_t now = time(NULL);
-    struct tm* tm_info = localtime(&now);
-    strftime(dump_filename, sizeof(dump_filename), 
-            "crash_dump_%Y%m%d_%H%M%S.dmp", tm_info);
-    
-    HANDLE dump_file = CreateFileA(dump_filename, GENERIC_WRITE, 0, NULL,
-                                  CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
-    
-    if (dump_file != INVALID_HANDLE_VALUE) {
-        MINIDUMP_EXCEPTION_INFORMATION dump_info;
-        dump_info.ThreadId = GetCurrentThreadId();
-        dump_info.ExceptionPointers = exception_pointers;
-        dump_info.ClientPointers = FALSE;
-        
-        MiniDumpWriteDump(GetCurrentProcess(), GetCurrentProcessId(),
-                         dump_file, MiniDumpNormal, &dump_info, NULL, NULL);
-        
-        CloseHandle(dump_file);
-        
-        if (g_eh_config.enable_console_output) {
-            fprintf(stderr, "Crash dump written: %s\n", dump_filename);
-        }
-    }
-}
-
-static LONG WINAPI eh_unhandled_exception_filter(EXCEPTION_POINTERS* exception_pointers) {
-    EH_PANIC("Unhandled exception: 0x%08X at address 0x%016llX",
-            exception_pointers->ExceptionRecord->ExceptionCode,
-            (unsigned long long)exception_pointers->ExceptionRecord->ExceptionAddress);
-    
-    eh_write_crash_dump(exception_pointers);
-    
-    return EXCEPTION_EXECUTE_HANDLER;
-}
-#endif
-
-#ifdef __cplusplus
-}
-#endif
-
+#ifndef ERROR_HANDLER_H
+#define ERROR_HANDLER_H
+
+/* The POSIX backend needs XSI (sigaltstack, SA_ONSTACK, localtime_r, ftruncate,
+ * clock_gettime, nanosleep), which glibc hides under -std=c11. Only takes effect
+ * when this header comes before any system include; otherwise build with
+ * -D_XOPEN_SOURCE=700 */
+#if defined(__linux__) && !defined(_XOPEN_SOURCE)
+    #define _XOPEN_SOURCE 700
+    #ifndef _DEFAULT_SOURCE
+        #define _DEFAULT_SOURCE 1
+    #endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Windows-specific includes */
+#ifdef _WIN32
+    #include <windows.h>
+    #include <dbghelp.h>
+    #include <excpt.h>
+    #include <signal.h>
+    #pragma comment(lib, "dbghelp.lib")
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* backtrace() for raw stack capture where the C library has it; define
+ * EH_STACK_FRAME_POINTERS to walk frame pointers instead */
+#if !defined(_WIN32) && (defined(__GLIBC__) || defined(__APPLE__))
+    #include <execinfo.h>
+    #define EH_HAVE_EXECINFO 1
+#endif
+
+#ifndef _WIN32
+    #include <pthread.h>
+    #include <sched.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/resource.h>
+    #include <signal.h>
+#endif
+
+/* Configuration macros */
+#ifndef EH_MAX_ERROR_MSG_SIZE
+    #define EH_MAX_ERROR_MSG_SIZE 1024
+#endif
+
+#ifndef EH_MAX_STACK_FRAMES
+    #define EH_MAX_STACK_FRAMES 64
+#endif
+
+/* Per-address symbol cache slots (must be a power of two) */
+#ifndef EH_SYMBOL_CACHE_SIZE
+    #define EH_SYMBOL_CACHE_SIZE 1024
+#endif
+
+/* Alternate stack for the crash signal handler, so stack overflows still get a report */
+#ifndef EH_SIGNAL_STACK_SIZE
+    #define EH_SIGNAL_STACK_SIZE (64 * 1024)
+#endif
+
+#ifndef EH_LOG_FILE_PATH
+    #define EH_LOG_FILE_PATH "error_log.txt"
+#endif
+
+#ifndef EH_BINARY_LOG_PATH
+    #define EH_BINARY_LOG_PATH "error_log.bin"
+#endif
+
+/* Mapped log file size; the file is rotated once it is full */
+#ifndef EH_LOG_ROTATE_SIZE
+    #define EH_LOG_ROTATE_SIZE (64 * 1024 * 1024)
+#endif
+
+/* Binary log write buffer; records are appended here and written in chunks */
+#ifndef EH_BINLOG_BUFFER_SIZE
+    #define EH_BINLOG_BUFFER_SIZE (64 * 1024)
+#endif
+
+/* Interned string cache slots (must be a power of two) */
+#ifndef EH_BINLOG_STRING_SLOTS
+    #define EH_BINLOG_STRING_SLOTS 4096
+#endif
+
+/* Maximum encoded argument bytes per binary record */
+#ifndef EH_BINLOG_MAX_ARGS_SIZE
+    #define EH_BINLOG_MAX_ARGS_SIZE 1024
+#endif
+
+/* Per-call-site rate limit (enable with EH_ENABLE_RATE_LIMIT): a site may
+ * log EH_RATE_LIMIT_BURST records at once, then one per interval */
+#ifndef EH_RATE_LIMIT_BURST
+    #define EH_RATE_LIMIT_BURST 10
+#endif
+
+#ifndef EH_RATE_LIMIT_INTERVAL_NS
+    #define EH_RATE_LIMIT_INTERVAL_NS 100000000ULL
+#endif
+
+/* Severities below this level are compiled out of the EH_* macros
+ * (0 = INFO, 1 = WARNING, 2 = ERROR, 3 = CRITICAL; PANIC is never removed) */
+#ifndef EH_MIN_SEVERITY
+    #define EH_MIN_SEVERITY 0
+#endif
+
+/* Async logging queue capacity in records (must be a power of two) */
+#ifndef EH_ASYNC_QUEUE_SIZE
+    #define EH_ASYNC_QUEUE_SIZE 1024
+#endif
+
+/* Maximum records the background writer formats before flushing */
+#ifndef EH_ASYNC_BATCH_SIZE
+    #define EH_ASYNC_BATCH_SIZE 256
+#endif
+
+/* How long the background writer sleeps when the queue is empty */
+#ifndef EH_ASYNC_IDLE_SLEEP_US
+    #define EH_ASYNC_IDLE_SLEEP_US 1000
+#endif
+
+/* Per-thread slots (statistics, allocation counters, pool caches) for
+ * threads alive at once; an exiting thread hands its slot to the next new
+ * one, threads beyond this share one atomic slot */
+#ifndef EH_MAX_THREADS
+    #define EH_MAX_THREADS 256
+#endif
+
+#ifndef EH_CACHE_LINE_SIZE
+    #define EH_CACHE_LINE_SIZE 64
+#endif
+
+/* Default block size for eh_arena_t */
+#ifndef EH_ARENA_BLOCK_SIZE
+    #define EH_ARENA_BLOCK_SIZE (64 * 1024)
+#endif
+
+/* Objects carved from the heap at once when an eh_pool_t runs dry */
+#ifndef EH_POOL_CHUNK_OBJECTS
+    #define EH_POOL_CHUNK_OBJECTS 256
+#endif
+
+/* Objects a thread moves between its eh_pool_t cache and the shared list at once */
+#ifndef EH_POOL_CACHE_BATCH
+    #define EH_POOL_CACHE_BATCH 32
+#endif
+
+/* Distinct EH_MALLOC call sites tracked with EH_ENABLE_ALLOC_TRACKING;
+ * sites past this are counted together (must be a power of two) */
+#ifndef EH_ALLOC_MAX_SITES
+    #define EH_ALLOC_MAX_SITES 1024
+#endif
+
+/* Thread-local storage, alignment and branch hints */
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define EH_THREAD_LOCAL __declspec(thread)
+    #define EH_ALIGNED(n) __declspec(align(n))
+    #define EH_UNLIKELY(x) (x)
+#else
+    #define EH_THREAD_LOCAL __thread
+    #define EH_ALIGNED(n) __attribute__((aligned(n)))
+    #define EH_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#endif
+
+/* Portable atomics (64-bit only, enough for the lock-free paths) */
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    static inline uint64_t eh_atomic_load(volatile uint64_t* ptr) {
+        uint64_t value = *ptr;
+        _ReadWriteBarrier();
+        return value;
+    }
+    static inline void eh_atomic_store(volatile uint64_t* ptr, uint64_t value) {
+        _ReadWriteBarrier();
+        *ptr = value;
+    }
+    static inline uint64_t eh_atomic_fetch_add(volatile uint64_t* ptr, uint64_t value) {
+        return (uint64_t)_InterlockedExchangeAdd64((volatile long long*)ptr, (long long)value);
+    }
+    static inline uint64_t eh_atomic_exchange(volatile uint64_t* ptr, uint64_t value) {
+        return (uint64_t)_InterlockedExchange64((volatile long long*)ptr, (long long)value);
+    }
+    static inline int eh_atomic_cas(volatile uint64_t* ptr, uint64_t* expected, uint64_t desired) {
+        uint64_t prev = (uint64_t)_InterlockedCompareExchange64((volatile long long*)ptr,
+                                                                (long long)desired, (long long)*expected);
+        if (prev == *expected) return 1;
+        *expected = prev;
+        return 0;
+    }
+#else
+    static inline uint64_t eh_atomic_load(volatile uint64_t* ptr) {
+        return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+    }
+    static inline void eh_atomic_store(volatile uint64_t* ptr, uint64_t value) {
+        __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+    }
+    static inline uint64_t eh_atomic_fetch_add(volatile uint64_t* ptr, uint64_t value) {
+        return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+    }
+    static inline uint64_t eh_atomic_exchange(volatile uint64_t* ptr, uint64_t value) {
+        return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+    }
+    static inline int eh_atomic_cas(volatile uint64_t* ptr, uint64_t* expected, uint64_t desired) {
+        return __atomic_compare_exchange_n(ptr, expected, desired, 0,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE);
+    }
+#endif
+
+/* Error severity levels */
+typedef enum {
+    EH_SEVERITY_INFO = 0,
+    EH_SEVERITY_WARNING,
+    EH_SEVERITY_ERROR,
+    EH_SEVERITY_CRITICAL,
+    EH_SEVERITY_PANIC
+} eh_severity_t;
+
+/* Error codes */
+typedef enum {
+    EH_SUCCESS = 0,
+    EH_ERROR_GENERIC = -1,
+    EH_ERROR_MEMORY = -2,
+    EH_ERROR_FILE_IO = -3,
+    EH_ERROR_INVALID_PARAM = -4,
+    EH_ERROR_NETWORK = -5,
+    EH_ERROR_TIMEOUT = -6,
+    EH_ERROR_ACCESS_DENIED = -7,
+    EH_ERROR_NOT_FOUND = -8,
+    EH_ERROR_ALREADY_EXISTS = -9,
+    EH_ERROR_CORRUPTED_DATA = -10,
+    EH_ERROR_SYSTEM_CALL = -999
+} eh_error_code_t;
+
+/* Error context structure */
+typedef struct {
+    eh_error_code_t code;
+    eh_severity_t severity;
+    char message[EH_MAX_ERROR_MSG_SIZE];
+    char function[128];
+    char file[256];
+    int line;
+#ifdef _WIN32
+    DWORD win32_error;
+#else
+    int os_errno;                               /* errno at the time of the report */
+#endif
+    time_t timestamp;
+    int call_depth;
+    int stack_depth;                            /* captured frames, 0 if none */
+    void* stack_frames[EH_MAX_STACK_FRAMES];    /* raw return addresses */
+} eh_error_context_t;
+
+/* What producers do when the async queue is full */
+typedef enum {
+    EH_ASYNC_BLOCK = 0,     /* wait for the writer to make room */
+    EH_ASYNC_DROP           /* discard the record and count it */
+} eh_async_policy_t;
+
+/* Configuration structure */
+typedef struct {
+    int enable_logging;
+    int enable_console_output;
+    int enable_debug_output;
+    int enable_stack_trace;
+    int enable_crash_dumps;
+    int abort_on_panic;
+    char log_file_path[512];
+    FILE* log_file_handle;
+    int enable_async_logging;
+    eh_async_policy_t async_overflow_policy;
+    eh_severity_t min_severity;
+    int enable_binary_log;
+    char binary_log_path[512];
+    int enable_mapped_log;              /* write log_file_path through a memory mapping */
+    size_t log_rotate_size;             /* mapping size, rotate when full */
+    int log_rotate_interval_s;          /* also rotate after this long (0 = never) */
+    int log_rotate_keep;                /* rotated files kept as path.1 .. path.N */
+    int log_flush_interval_ms;          /* async msync at most this often */
+    eh_severity_t log_flush_severity;   /* sync flush at this level (CRITICAL+ always) */
+    eh_severity_t stack_trace_min_severity; /* capture raw frames from this level up */
+} eh_config_t;
+
+/* Global configuration */
+static eh_config_t g_eh_config = {
+    .enable_logging = 1,
+    .enable_console_output = 1,
+    .enable_debug_output = 1,
+    .enable_stack_trace = 1,
+    .enable_crash_dumps = 1,
+    .abort_on_panic = 1,
+    .log_file_path = EH_LOG_FILE_PATH,
+    .log_file_handle = NULL,
+    .enable_async_logging = 0,
+    .async_overflow_policy = EH_ASYNC_BLOCK,
+    .min_severity = EH_SEVERITY_INFO,
+    .enable_binary_log = 0,
+    .binary_log_path = EH_BINARY_LOG_PATH,
+    .enable_mapped_log = 0,
+    .log_rotate_size = EH_LOG_ROTATE_SIZE,
+    .log_rotate_interval_s = 0,
+    .log_rotate_keep = 5,
+    .log_flush_interval_ms = 1000,
+    .log_flush_severity = EH_SEVERITY_CRITICAL,
+    .stack_trace_min_severity = EH_SEVERITY_ERROR
+};
+
+/* Function pointer for custom error handlers */
+typedef void (*eh_custom_handler_t)(const eh_error_context_t* context);
+static eh_custom_handler_t g_custom_handler = NULL;
+
+/* Internal state tracking: 0 = not initialized, 1 = eh_init running, 2 = ready */
+static volatile uint64_t g_eh_initialized = 0;
+
+/* Error statistics: one cache line per thread, summed on read */
+typedef struct {
+    volatile uint64_t errors;
+    volatile uint64_t warnings;
+    char pad[EH_CACHE_LINE_SIZE - 2 * sizeof(uint64_t)];
+} eh_thread_stats_t;
+
+static EH_ALIGNED(EH_CACHE_LINE_SIZE) eh_thread_stats_t g_eh_thread_stats[EH_MAX_THREADS + 1];
+static volatile uint64_t g_eh_thread_slot_used[EH_MAX_THREADS];
+static volatile uint64_t g_eh_thread_slot_key = 0;     /* exit hook key + 1, 0 = not created */
+static EH_THREAD_LOCAL uint64_t t_eh_thread_slot = 0;  /* slot + 1, 0 = unassigned */
+static EH_THREAD_LOCAL eh_thread_stats_t* t_eh_thread_stats = NULL;
+static EH_THREAD_LOCAL struct eh_alloc_counters* t_eh_alloc_table = NULL;  /* allocation counters */
+static EH_THREAD_LOCAL eh_error_context_t t_eh_last_error;
+static EH_THREAD_LOCAL int t_eh_in_init = 0;
+
+/* Async logging state: bounded MPSC ring drained by one writer thread */
+typedef struct {
+    volatile uint64_t sequence;
+    eh_error_context_t context;
+} eh_async_slot_t;
+
+#ifdef _WIN32
+typedef HANDLE eh_thread_t;
+#else
+typedef pthread_t eh_thread_t;
+#endif
+
+static struct {
+    eh_async_slot_t* slots;
+    eh_thread_t writer;
+    volatile uint64_t running;
+    volatile uint64_t active_producers;
+    volatile uint64_t stop_requested;
+    volatile uint64_t dropped;
+    char pad0[64];
+    volatile uint64_t enqueue_pos;
+    char pad1[64];
+    uint64_t dequeue_pos;
+} g_eh_async;
+
+/* Binary log state; strings are looked up by pointer, checked against a copy
+ * of their text, and written once */
+typedef struct {
+    FILE* file;
+    volatile uint64_t lock;
+    size_t used;
+    uint32_t next_string_id;
+    const char* string_keys[EH_BINLOG_STRING_SLOTS];
+    char* string_text[EH_BINLOG_STRING_SLOTS];
+    uint32_t string_ids[EH_BINLOG_STRING_SLOTS];
+    unsigned char buffer[EH_BINLOG_BUFFER_SIZE];
+} eh_binlog_t;
+
+static eh_binlog_t* g_eh_binlog = NULL;
+/* Same guard as the async queue: writers register before touching g_eh_binlog */
+static volatile uint64_t g_eh_binlog_active = 0;
+static volatile uint64_t g_eh_binlog_producers = 0;
+
+/* Memory-mapped log file state */
+typedef struct {
+    char* base;
+    size_t capacity;
+    size_t offset;
+    uint64_t opened_ns;
+    uint64_t last_flush_ns;
+    int unsynced;                   /* written to since the last msync */
+    volatile uint64_t lock;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+} eh_mapped_log_t;
+
+static eh_mapped_log_t* g_eh_mapped_log = NULL;
+
+/* Symbolized frames, keyed by return address */
+typedef struct {
+    void* address;
+    char name[240];
+} eh_symbol_entry_t;
+
+static struct {
+    volatile uint64_t lock;
+    eh_symbol_entry_t* entries;
+} g_eh_symbols;
+
+/* Rate limiter state, one static instance per EH_* macro expansion */
+typedef struct eh_rate_limit eh_rate_limit_t;
+struct eh_rate_limit {
+    volatile uint64_t tat;          /* GCRA theoretical arrival time in ns */
+    volatile uint64_t suppressed;
+    volatile uint64_t registered;
+    eh_rate_limit_t* next;
+    const char* function;
+    const char* file;
+    int line;
+    eh_error_code_t code;
+    eh_severity_t severity;
+};
+
+/* Sites that have suppressed at least once, so eh_cleanup can report them */
+static eh_rate_limit_t* volatile g_eh_rate_sites = NULL;
+
+/* Forward declarations */
+static void eh_internal_log(const eh_error_context_t* context);
+static void eh_internal_log_sync(const eh_error_context_t* context, int flush);
+static int eh_async_start(void);
+static void eh_async_stop(void);
+static void eh_log_file_open(void);
+static void eh_log_file_close(void);
+static int eh_log_file_active(void);
+static void eh_log_file_write(const char* text, eh_severity_t severity, int flush);
+static int eh_binlog_open(const char* path);
+static void eh_binlog_close(void);
+static void eh_binlog_write(eh_error_code_t code, eh_severity_t severity, const char* function,
+                            const char* file, int line, const char* format, va_list args);
+static inline int eh_get_error_count(void);
+static inline int eh_get_warning_count(void);
+static inline void eh_rate_limit_flush(void);
+static void eh_print_stack_trace(void);
+static int eh_capture_stack(void** frames, int max_frames, int skip);
+static void eh_write_stack_frames(const eh_error_context_t* context);
+static const char* eh_severity_to_string(eh_severity_t severity);
+static const char* eh_error_code_to_string(eh_error_code_t code);
+#ifdef _WIN32
+static void eh_write_crash_dump(EXCEPTION_POINTERS* exception_pointers);
+static LONG WINAPI eh_unhandled_exception_filter(EXCEPTION_POINTERS* exception_pointers);
+#else
+static void eh_install_signal_handlers(void);
+static void eh_restore_signal_handlers(void);
+#endif
+static inline void eh_thread_init(void);
+
+/* Initialization and cleanup */
+static inline int eh_init(void) {
+    if (eh_atomic_load(&g_eh_initialized) == 2 || t_eh_in_init) return EH_SUCCESS;
+    
+    /* First caller wins; concurrent callers wait so nobody logs half set up
+     * and only one writer thread, log mapping and handler set ever exists */
+    uint64_t expected = 0;
+    if (!eh_atomic_cas(&g_eh_initialized, &expected, 1)) {
+        while (eh_atomic_load(&g_eh_initialized) == 1) {
+#ifdef _WIN32
+            SwitchToThread();
+#else
+            sched_yield();
+#endif
+        }
+        return EH_SUCCESS;
+    }
+    t_eh_in_init = 1;     /* errors logged while initializing don't re-enter */
+    
+#ifdef _WIN32
+    /* Initialize symbol handler for stack traces */
+    if (g_eh_config.enable_stack_trace) {
+        SymInitialize(GetCurrentProcess(), NULL, TRUE);
+        SymSetOptions(SYMOPT_LOAD_LINES | SYMOPT_UNDNAME);
+    }
+    
+    /* Set up unhandled exception filter */
+    SetUnhandledExceptionFilter(eh_unhandled_exception_filter);
+    
+    /* Set up console control handler for graceful shutdown */
+    SetConsoleCtrlHandler(NULL, FALSE);
+#else
+#ifdef EH_HAVE_EXECINFO
+    /* The first backtrace() call loads the unwinder; do it now, not mid-error
+     * and never for the first time inside a signal handler */
+    if (g_eh_config.enable_stack_trace || g_eh_config.enable_crash_dumps) {
+        void* warmup[1];
+        backtrace(warmup, 1);
+    }
+#endif
+    
+#ifdef EH_ENABLE_CORE_DUMPS
+    /* Let the kernel write a core file after the crash report */
+    struct rlimit core_limit;
+    if (getrlimit(RLIMIT_CORE, &core_limit) == 0) {
+        core_limit.rlim_cur = core_limit.rlim_max;
+        setrlimit(RLIMIT_CORE, &core_limit);
+    }
+#endif
+    
+    /* Fatal signals stand in for the unhandled exception filter */
+    if (g_eh_config.enable_crash_dumps) {
+        eh_install_signal_handlers();
+    }
+#endif
+    
+    /* Open log file if logging is enabled */
+    if (g_eh_config.enable_logging) {
+        eh_log_file_open();
+        if (eh_log_file_active()) {
+            eh_log_file_write("\n=== Error Handler Initialized [" __TIMESTAMP__ "] ===\n",
+                              EH_SEVERITY_INFO, 1);
+        }
+    }
+    
+    if (g_eh_config.enable_binary_log) {
+        eh_binlog_open(g_eh_config.binary_log_path);
+    }
+    
+    if (g_eh_config.enable_async_logging) {
+        eh_async_start();
+    }
+    
+    t_eh_in_init = 0;
+    eh_atomic_store(&g_eh_initialized, 2);
+    return EH_SUCCESS;
+}
+
+static inline void eh_cleanup(void) {
+    if (eh_atomic_load(&g_eh_initialized) != 2) return;
+    
+    /* Report sites still holding back records, then drain the queue */
+    eh_rate_limit_flush();
+    
+    /* Drain every queued record before the log file goes away */
+    eh_async_stop();
+    eh_binlog_close();
+    
+    if (eh_log_file_active()) {
+        char summary[128];
+        snprintf(summary, sizeof(summary), "=== Error Handler Shutdown ===\nTotal Errors: %d, Warnings: %d\n",
+                eh_get_error_count(), eh_get_warning_count());
+        eh_log_file_write(summary, EH_SEVERITY_INFO, 1);
+    }
+    eh_log_file_close();
+    
+#ifdef _WIN32
+    if (g_eh_config.enable_stack_trace) {
+        SymCleanup(GetCurrentProcess());
+    }
+#else
+    eh_restore_signal_handlers();
+#endif
+    
+    free(g_eh_symbols.entries);
+    g_eh_symbols.entries = NULL;
+    
+    eh_atomic_store(&g_eh_initialized, 0);
+}
+
+/* Configuration functions */
+static inline void eh_set_config(const eh_config_t* config) {
+    if (config) {
+        /* The writer thread reads the config, so drain it before swapping */
+        eh_async_stop();
+        eh_binlog_close();
+        if (g_eh_mapped_log) eh_log_file_close();
+        g_eh_config = *config;
+        if (eh_atomic_load(&g_eh_initialized) == 2 && g_eh_config.enable_logging) {
+            eh_log_file_open();
+        }
+        if (eh_atomic_load(&g_eh_initialized) == 2 && g_eh_config.enable_binary_log) {
+            eh_binlog_open(g_eh_config.binary_log_path);
+        }
+        if (eh_atomic_load(&g_eh_initialized) == 2 && g_eh_config.enable_async_logging) {
+            eh_async_start();
+        }
+    }
+}
+
+static inline void eh_set_custom_handler(eh_custom_handler_t handler) {
+    g_custom_handler = handler;
+}
+
+/* Runtime level filter, checked before any formatting happens */
+static inline void eh_set_min_severity(eh_severity_t severity) {
+    g_eh_config.min_severity = severity;
+}
+
+static inline int eh_severity_enabled(eh_severity_t severity) {
+    return severity >= g_eh_config.min_severity || severity == EH_SEVERITY_PANIC;
+}
+
+/* Bounded copy that does not zero-pad the rest of the buffer like strncpy */
+static inline void eh_copy_string(char* dest, size_t size, const char* src) {
+    size_t len = strlen(src);
+    if (len >= size) len = size - 1;
+    memcpy(dest, src, len);
+    dest[len] = '\0';
+}
+
+/* Cheap monotonic clock for the rate limiter */
+static inline uint64_t eh_monotonic_ns(void) {
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64() * 1000000ULL;
+#else
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* Lock-free GCRA token bucket; on success *suppressed is how many records
+ * this site dropped since it last logged */
+static inline int eh_rate_limit_check(eh_rate_limit_t* site, uint64_t* suppressed,
+                                      eh_error_code_t code, eh_severity_t severity,
+                                      const char* function, const char* file, int line) {
+    const uint64_t tolerance = (EH_RATE_LIMIT_BURST - 1) * (uint64_t)EH_RATE_LIMIT_INTERVAL_NS;
+    uint64_t now = eh_monotonic_ns();
+    uint64_t tat = eh_atomic_load(&site->tat);
+    
+    for (;;) {
+        uint64_t base = tat > now ? tat : now;
+        if (base - now > tolerance) {
+            eh_atomic_fetch_add(&site->suppressed, 1);
+            
+            /* First suppression registers the site for the shutdown summary */
+            uint64_t expected = 0;
+            if (!site->registered && eh_atomic_cas(&site->registered, &expected, 1)) {
+                site->function = function;
+                site->file = file;
+                site->line = line;
+                site->code = code;
+                site->severity = severity;
+                uint64_t head = (uint64_t)(uintptr_t)g_eh_rate_sites;
+                do {
+                    site->next = (eh_rate_limit_t*)(uintptr_t)head;
+                } while (!eh_atomic_cas((volatile uint64_t*)(void*)&g_eh_rate_sites, &head,
+                                        (uint64_t)(uintptr_t)site));
+            }
+            return 0;
+        }
+        if (eh_atomic_cas(&site->tat, &tat, base + EH_RATE_LIMIT_INTERVAL_NS)) break;
+    }
+    
+    *suppressed = site->suppressed ? eh_atomic_exchange(&site->suppressed, 0) : 0;
+    return 1;
+}
+
+/* Thread exit: whatever the slot holds (counts, counter table, pool caches)
+ * stays and the next new thread takes it over, so exactly one live thread
+ * ever writes to it */
+static inline void eh_thread_slot_release(void* value) {
+    uint64_t slot = (uint64_t)(uintptr_t)value - 1;
+    t_eh_thread_slot = 0;  /* a later log call (another exit hook) claims again */
+    t_eh_thread_stats = NULL;
+    t_eh_alloc_table = NULL;
+    if (slot < EH_MAX_THREADS) eh_atomic_store(&g_eh_thread_slot_used[slot], 0);
+}
+
+#ifdef _WIN32
+static VOID WINAPI eh_thread_slot_release_fls(PVOID value) {
+    if (value) eh_thread_slot_release(value);
+}
+#endif
+
+/* Release the slot at thread exit; without a key (none could be created) it
+ * stays taken */
+static inline void eh_thread_slot_hook(uint64_t slot) {
+    uint64_t key = eh_atomic_load(&g_eh_thread_slot_key);
+    if (key == 0) {
+#ifdef _WIN32
+        DWORD created = FlsAlloc(eh_thread_slot_release_fls);
+        if (created == FLS_OUT_OF_INDEXES) return;
+#else
+        pthread_key_t created;
+        if (pthread_key_create(&created, eh_thread_slot_release) != 0) return;
+#endif
+        if (eh_atomic_cas(&g_eh_thread_slot_key, &key, (uint64_t)created + 1)) {
+            key = (uint64_t)created + 1;
+        } else {
+#ifdef _WIN32
+            FlsFree(created);  /* another thread's key won */
+#else
+            pthread_key_delete(created);
+#endif
+        }
+    }
+#ifdef _WIN32
+    FlsSetValue((DWORD)(key - 1), (PVOID)(uintptr_t)(slot + 1));
+#else
+    pthread_setspecific((pthread_key_t)(key - 1), (void*)(uintptr_t)(slot + 1));
+#endif
+}
+
+/* Small per-thread index, 0..EH_MAX_THREADS; the last is shared by threads
+ * that found every slot taken (they keep it for life) */
+static inline uint64_t eh_thread_slot(void) {
+    if (t_eh_thread_slot == 0) {
+        uint64_t slot = EH_MAX_THREADS;
+        for (uint64_t i = 0; i < EH_MAX_THREADS; i++) {
+            uint64_t expected = 0;
+            if (eh_atomic_load(&g_eh_thread_slot_used[i]) == 0 &&
+                eh_atomic_cas(&g_eh_thread_slot_used[i], &expected, 1)) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < EH_MAX_THREADS) eh_thread_slot_hook(slot);
+        t_eh_thread_slot = slot + 1;
+    }
+    return t_eh_thread_slot - 1;
+}
+
+/* Statistics helpers */
+static inline eh_thread_stats_t* eh_thread_stats(void) {
+    if (!t_eh_thread_stats) {
+        t_eh_thread_stats = &g_eh_thread_stats[eh_thread_slot()];
+    }
+    return t_eh_thread_stats;
+}
+
+static inline void eh_stats_increment(volatile uint64_t* counter) {
+    if (t_eh_thread_stats == &g_eh_thread_stats[EH_MAX_THREADS]) {
+        /* Overflow slot is shared between threads */
+        eh_atomic_fetch_add(counter, 1);
+    } else {
+        /* Only the owning thread writes; readers just need an untorn value */
+        eh_atomic_store(counter, *counter + 1);
+    }
+}
+
+static inline uint64_t eh_stats_sum(size_t offset) {
+    uint64_t total = 0;
+    for (uint64_t i = 0; i <= EH_MAX_THREADS; i++) {
+        total += eh_atomic_load((volatile uint64_t*)((char*)&g_eh_thread_stats[i] + offset));
+    }
+    return total;
+}
+
+/* True when some sink other than the binary log consumes the formatted text */
+static inline int eh_text_output_needed(eh_severity_t severity) {
+    if (!eh_atomic_load(&g_eh_binlog_active) || g_custom_handler || severity == EH_SEVERITY_PANIC) return 1;
+    if (g_eh_config.enable_console_output) return 1;
+    if (eh_log_file_active()) return 1;
+#ifdef _WIN32
+    if (g_eh_config.enable_debug_output && IsDebuggerPresent()) return 1;
+#endif
+    return 0;
+}
+
+/* Core error handling function */
+static inline void eh_handle_error_internal(eh_error_code_t code, eh_severity_t severity,
+                                          const char* function, const char* file, int line,
+                                          const char* format, va_list args) {
+    if (!eh_severity_enabled(severity)) return;
+    if (eh_atomic_load(&g_eh_initialized) != 2) eh_init();
+    eh_thread_init(); /* no-op once this thread has its signal stack */
+    
+    eh_error_context_t context;
+#ifdef _WIN32
+    context.win32_error = GetLastError();
+#else
+    context.os_errno = errno;
+#endif
+    context.code = code;
+    context.severity = severity;
+    context.line = line;
+    context.timestamp = time(NULL);
+    context.call_depth = 0; /* Could be enhanced with call stack analysis */
+    
+    /* Raw return addresses only; symbolization happens when the record is written */
+    context.stack_depth = 0;
+    if (g_eh_config.enable_stack_trace && severity >= g_eh_config.stack_trace_min_severity) {
+        context.stack_depth = eh_capture_stack(context.stack_frames, EH_MAX_STACK_FRAMES, 1);
+    }
+    
+    /* Binary sink stores the raw arguments; formatting happens offline */
+    if (eh_atomic_load(&g_eh_binlog_active)) {
+        va_list binary_args;
+        va_copy(binary_args, args);
+        eh_binlog_write(code, severity, function, file, line, format, binary_args);
+        va_end(binary_args);
+    }
+    
+    /* Copy function and file names safely */
+    eh_copy_string(context.function, sizeof(context.function), function ? function : "unknown");
+    eh_copy_string(context.file, sizeof(context.file), file ? file : "unknown");
+    
+    /* The message is always formatted: it becomes the last error, which
+     * eh_get_last_error and crash reports show. With the binary log as the
+     * only reader, the log line and its output are still skipped */
+    int needs_text = eh_text_output_needed(severity);
+    vsnprintf(context.message, sizeof(context.message), format, args);
+    
+    /* Update statistics */
+    if (severity >= EH_SEVERITY_ERROR) eh_stats_increment(&eh_thread_stats()->errors);
+    else if (severity == EH_SEVERITY_WARNING) eh_stats_increment(&eh_thread_stats()->warnings);
+    
+    /* Store as last error */
+    t_eh_last_error = context;
+    
+    /* Call custom handler if set */
+    if (g_custom_handler) {
+        g_custom_handler(&context);
+    }
+    
+    /* Internal logging */
+    if (needs_text) {
+        eh_internal_log(&context);
+    }
+    
+    /* Handle panic condition */
+    if (severity == EH_SEVERITY_PANIC) {
+        if (g_eh_config.enable_stack_trace && context.stack_depth == 0) {
+            eh_print_stack_trace();
+        }
+        
+        if (g_eh_config.abort_on_panic) {
+            if (g_eh_config.enable_console_output) {
+                fprintf(stderr, "\n*** PANIC: Application will terminate ***\n");
+            }
+            eh_cleanup();
+            abort();
+        }
+    }
+}
+
+/* Variadic wrapper functions */
+static inline void eh_handle_error(eh_error_code_t code, eh_severity_t severity,
+                                 const char* function, const char* file, int line,
+                                 const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    eh_handle_error_internal(code, severity, function, file, line, format, args);
+    va_end(args);
+}
+
+/* Convenience macros
+ * Disabled levels cost one branch at runtime and nothing when compiled out;
+ * the arguments are not evaluated in either case. */
+#ifdef EH_ENABLE_RATE_LIMIT
+#define EH_LOG_AT(severity, code, ...) \
+    do { \
+        if (EH_UNLIKELY(eh_severity_enabled(severity))) { \
+            static eh_rate_limit_t eh_rate_site_; \
+            uint64_t eh_rate_suppressed_; \
+            if (eh_rate_limit_check(&eh_rate_site_, &eh_rate_suppressed_, code, severity, \
+                                    __FUNCTION__, __FILE__, __LINE__)) { \
+                if (eh_rate_suppressed_) { \
+                    eh_handle_error(code, severity, __FUNCTION__, __FILE__, __LINE__, \
+                                    "suppressed %llu similar messages", \
+                                    (unsigned long long)eh_rate_suppressed_); \
+                } \
+                eh_handle_error(code, severity, __FUNCTION__, __FILE__, __LINE__, __VA_ARGS__); \
+            } \
+        } \
+    } while(0)
+#else
+#define EH_LOG_AT(severity, code, ...) \
+    do { \
+        if (EH_UNLIKELY(eh_severity_enabled(severity))) { \
+            eh_handle_error(code, severity, __FUNCTION__, __FILE__, __LINE__, __VA_ARGS__); \
+        } \
+    } while(0)
+#endif
+
+/* Keeps the arguments type-checked without generating any code */
+#define EH_LOG_DISABLED(severity, code, ...) \
+    do { \
+        if (0) { \
+            eh_handle_error(code, severity, __FUNCTION__, __FILE__, __LINE__, __VA_ARGS__); \
+        } \
+    } while(0)
+
+#if EH_MIN_SEVERITY <= 0
+#define EH_INFO(code, ...) EH_LOG_AT(EH_SEVERITY_INFO, code, __VA_ARGS__)
+#else
+#define EH_INFO(code, ...) EH_LOG_DISABLED(EH_SEVERITY_INFO, code, __VA_ARGS__)
+#endif
+
+#if EH_MIN_SEVERITY <= 1
+#define EH_WARN(code, ...) EH_LOG_AT(EH_SEVERITY_WARNING, code, __VA_ARGS__)
+#else
+#define EH_WARN(code, ...) EH_LOG_DISABLED(EH_SEVERITY_WARNING, code, __VA_ARGS__)
+#endif
+
+#if EH_MIN_SEVERITY <= 2
+#define EH_ERROR(code, ...) EH_LOG_AT(EH_SEVERITY_ERROR, code, __VA_ARGS__)
+#else
+#define EH_ERROR(code, ...) EH_LOG_DISABLED(EH_SEVERITY_ERROR, code, __VA_ARGS__)
+#endif
+
+#if EH_MIN_SEVERITY <= 3
+#define EH_CRITICAL(code, ...) EH_LOG_AT(EH_SEVERITY_CRITICAL, code, __VA_ARGS__)
+#else
+#define EH_CRITICAL(code, ...) EH_LOG_DISABLED(EH_SEVERITY_CRITICAL, code, __VA_ARGS__)
+#endif
+
+#define EH_PANIC(...) \
+    eh_handle_error(EH_ERROR_GENERIC, EH_SEVERITY_PANIC, __FUNCTION__, __FILE__, __LINE__, __VA_ARGS__)
+
+/* Assertion macros with better error reporting */
+#define EH_ASSERT(condition, ...) \
+    do { \
+        if (!(condition)) { \
+            EH_PANIC("Assertion failed: " #condition ". " __VA_ARGS__); \
+        } \
+    } while(0)
+
+#define EH_ASSERT_NOT_NULL(ptr, ...) \
+    EH_ASSERT((ptr) != NULL, "Null pointer: " #ptr ". " __VA_ARGS__)
+
+/* Allocation tracking
+ * With EH_ENABLE_ALLOC_TRACKING every EH_MALLOC/EH_CALLOC/EH_REALLOC block
+ * carries a small header naming its call site, and EH_FREE charges the free
+ * back to that site. Every pointer handed to EH_REALLOC/EH_FREE must then come
+ * from the EH_* wrappers, and their blocks must not go to plain free(). */
+#ifdef EH_ENABLE_ALLOC_TRACKING
+#define EH_ALLOC_MAGIC 0xA110C8EDu
+
+/* Sits in front of each tracked block; 16 bytes keeps malloc's alignment */
+typedef struct {
+    uint64_t size;
+    uint32_t site;
+    uint32_t magic;
+} eh_alloc_header_t;
+
+/* Call site registry, shared and filled in lock-free; slot 0 collects
+ * everything that did not fit */
+typedef struct {
+    volatile uint64_t key;          /* 0 while the slot is free */
+    volatile uint64_t ready;        /* set once the fields below are written */
+    const char* function;
+    const char* file;
+    int line;
+    volatile uint64_t live_bytes;
+    volatile uint64_t peak_bytes;
+} eh_alloc_site_t;
+
+/* Per-thread counters, one row per site, written only by the owning thread */
+typedef struct eh_alloc_counters {
+    volatile uint64_t allocs;
+    volatile uint64_t frees;
+    volatile uint64_t bytes_allocated;
+    volatile uint64_t bytes_freed;
+} eh_alloc_counters_t;
+
+static eh_alloc_site_t g_eh_alloc_sites[EH_ALLOC_MAX_SITES];
+static eh_alloc_counters_t* volatile g_eh_alloc_tables[EH_MAX_THREADS];   /* by thread slot */
+static eh_alloc_counters_t g_eh_alloc_shared[EH_ALLOC_MAX_SITES];
+
+static inline uint32_t eh_alloc_site_id(const char* function, const char* file, int line) {
+    uint64_t key = ((uint64_t)(uintptr_t)file ^ ((uint64_t)(uint32_t)line << 32)) *
+                   0x9E3779B97F4A7C15ULL;
+    key |= 1;
+    
+    uint32_t mask = EH_ALLOC_MAX_SITES - 1;
+    uint32_t index = (uint32_t)(key >> 40) & mask;
+    for (uint32_t probe = 0; probe < EH_ALLOC_MAX_SITES; probe++, index = (index + 1) & mask) {
+        if (index == 0) continue;
+        eh_alloc_site_t* site = &g_eh_alloc_sites[index];
+        uint64_t current = eh_atomic_load(&site->key);
+        
+        if (current == 0) {
+            uint64_t expected = 0;
+            if (eh_atomic_cas(&site->key, &expected, key)) {
+                site->function = function;
+                site->file = file;
+                site->line = line;
+                eh_atomic_store(&site->ready, 1);
+                return index;
+            }
+            current = expected;
+        }
+        if (current == key) {
+            /* Claimed by another thread a moment ago; its fields land shortly */
+            while (!eh_atomic_load(&site->ready)) {
+#ifdef _WIN32
+                SwitchToThread();
+#else
+                sched_yield();
+#endif
+            }
+            if (site->file == file && site->line == line) return index;
+        }
+    }
+    return 0;
+}
+
+/* The slot's table, allocated by its first owner and kept for the next */
+static inline eh_alloc_counters_t* eh_alloc_thread_table(void) {
+    if (!t_eh_alloc_table) {
+        t_eh_alloc_table = g_eh_alloc_shared;
+        uint64_t slot = eh_thread_slot();
+        if (slot < EH_MAX_THREADS) {
+            eh_alloc_counters_t* table = g_eh_alloc_tables[slot];
+            if (!table) {
+                table = (eh_alloc_counters_t*)calloc(EH_ALLOC_MAX_SITES, sizeof(eh_alloc_counters_t));
+                if (table) g_eh_alloc_tables[slot] = table;
+            }
+            if (table) t_eh_alloc_table = table;
+        }
+    }
+    return t_eh_alloc_table;
+}
+
+static inline void eh_alloc_count(volatile uint64_t* counter, uint64_t value, int shared) {
+    if (shared) eh_atomic_fetch_add(counter, value);
+    else eh_atomic_store(counter, *counter + value);
+}
+
+static inline void eh_alloc_record(uint32_t site_id, uint64_t size, int is_free) {
+    eh_alloc_counters_t* table = eh_alloc_thread_table();
+    eh_alloc_counters_t* row = &table[site_id];
+    int shared = (table == g_eh_alloc_shared);
+    eh_alloc_site_t* site = &g_eh_alloc_sites[site_id];
+    
+    if (is_free) {
+        eh_alloc_count(&row->frees, 1, shared);
+        eh_alloc_count(&row->bytes_freed, size, shared);
+        eh_atomic_fetch_add(&site->live_bytes, (uint64_t)0 - size);
+        return;
+    }
+    
+    eh_alloc_count(&row->allocs, 1, shared);
+    eh_alloc_count(&row->bytes_allocated, size, shared);
+    
+    /* Live bytes move between threads, so they stay on the site itself */
+    uint64_t live = eh_atomic_fetch_add(&site->live_bytes, size) + size;
+    uint64_t peak = eh_atomic_load(&site->peak_bytes);
+    while (live > peak && !eh_atomic_cas(&site->peak_bytes, &peak, live)) {
+    }
+}
+
+static inline void* eh_alloc_attach(void* base, uint64_t size, uint32_t site_id) {
+    eh_alloc_header_t* header = (eh_alloc_header_t*)base;
+    header->size = size;
+    header->site = site_id;
+    header->magic = EH_ALLOC_MAGIC;
+    eh_alloc_record(site_id, size, 0);
+    return header + 1;
+}
+
+/* Header of a tracked block, or NULL if ptr did not come from the EH_* wrappers */
+static inline eh_alloc_header_t* eh_alloc_header(void* ptr) {
+    eh_alloc_header_t* header = (eh_alloc_header_t*)ptr - 1;
+    return header->magic == EH_ALLOC_MAGIC ? header : NULL;
+}
+
+/* Per-site totals as reported by eh_alloc_report */
+typedef struct {
+    const char* function;
+    const char* file;
+    int line;
+    uint64_t live_bytes;
+    uint64_t peak_bytes;
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t bytes_allocated;
+} eh_alloc_site_stats_t;
+
+static inline int eh_alloc_compare_live(const void* a, const void* b) {
+    const eh_alloc_site_stats_t* left = (const eh_alloc_site_stats_t*)a;
+    const eh_alloc_site_stats_t* right = (const eh_alloc_site_stats_t*)b;
+    if (left->live_bytes != right->live_bytes) return left->live_bytes < right->live_bytes ? 1 : -1;
+    if (left->peak_bytes != right->peak_bytes) return left->peak_bytes < right->peak_bytes ? 1 : -1;
+    return 0;
+}
+
+/* Sums the per-thread tables into one row per site; returns the number of
+ * rows written, at most max_sites */
+static inline int eh_alloc_collect(eh_alloc_site_stats_t* out, int max_sites) {
+    uint64_t tables = EH_MAX_THREADS;
+    int count = 0;
+    
+    for (uint32_t i = 0; i < EH_ALLOC_MAX_SITES && count < max_sites; i++) {
+        eh_alloc_site_t* site = &g_eh_alloc_sites[i];
+        if (i != 0 && !eh_atomic_load(&site->ready)) continue;
+        
+        eh_alloc_site_stats_t stats;
+        memset(&stats, 0, sizeof(stats));
+        stats.function = i ? site->function : "(other)";
+        stats.file = i ? site->file : "(sites beyond EH_ALLOC_MAX_SITES)";
+        stats.line = i ? site->line : 0;
+        stats.live_bytes = eh_atomic_load(&site->live_bytes);
+        stats.peak_bytes = eh_atomic_load(&site->peak_bytes);
+        
+        for (uint64_t t = 0; t <= tables; t++) {
+            eh_alloc_counters_t* table = t < tables ? g_eh_alloc_tables[t] : g_eh_alloc_shared;
+            if (!table) continue;
+            stats.allocs += eh_atomic_load(&table[i].allocs);
+            stats.frees += eh_atomic_load(&table[i].frees);
+            stats.bytes_allocated += eh_atomic_load(&table[i].bytes_allocated);
+        }
+        if (stats.allocs == 0) continue;
+        out[count++] = stats;
+    }
+    return count;
+}
+
+/* Prints the top_n sites by live bytes (all sites if top_n <= 0) */
+static inline void eh_alloc_report(FILE* output, int top_n) {
+    eh_alloc_site_stats_t* sites = (eh_alloc_site_stats_t*)malloc(EH_ALLOC_MAX_SITES *
+                                                                  sizeof(eh_alloc_site_stats_t));
+    if (!sites) return;
+    
+    int count = eh_alloc_collect(sites, EH_ALLOC_MAX_SITES);
+    qsort(sites, (size_t)count, sizeof(eh_alloc_site_stats_t), eh_alloc_compare_live);
+    if (top_n <= 0 || top_n > count) top_n = count;
+    
+    uint64_t total_live = 0;
+    for (int i = 0; i < count; i++) total_live += sites[i].live_bytes;
+    
+    fprintf(output, "=== Allocation Report: top %d of %d sites, %llu bytes live ===\n",
+            top_n, count, (unsigned long long)total_live);
+    fprintf(output, "%14s %14s %10s %10s  %s\n", "live bytes", "peak bytes", "allocs", "frees", "site");
+    for (int i = 0; i < top_n; i++) {
+        fprintf(output, "%14llu %14llu %10llu %10llu  %s() at %s:%d\n",
+                (unsigned long long)sites[i].live_bytes, (unsigned long long)sites[i].peak_bytes,
+                (unsigned long long)sites[i].allocs, (unsigned long long)sites[i].frees,
+                sites[i].function, sites[i].file, sites[i].line);
+    }
+    free(sites);
+}
+#endif
+
+/* Memory allocation with error handling */
+#define EH_MALLOC(size) eh_safe_malloc(size, __FUNCTION__, __FILE__, __LINE__)
+#define EH_CALLOC(count, size) eh_safe_calloc(count, size, __FUNCTION__, __FILE__, __LINE__)
+#define EH_REALLOC(ptr, size) eh_safe_realloc(ptr, size, __FUNCTION__, __FILE__, __LINE__)
+#define EH_FREE(ptr) eh_safe_free((void**)&(ptr))
+
+static inline void* eh_safe_malloc(size_t size, const char* function, const char* file, int line) {
+#ifdef EH_ENABLE_ALLOC_TRACKING
+    void* base = size <= SIZE_MAX - sizeof(eh_alloc_header_t) ?
+                 malloc(sizeof(eh_alloc_header_t) + size) : NULL;
+    void* ptr = base ? eh_alloc_attach(base, size, eh_alloc_site_id(function, file, line)) : NULL;
+#else
+    void* ptr = malloc(size);
+#endif
+    if (!ptr && size > 0) {
+        eh_handle_error(EH_ERROR_MEMORY, EH_SEVERITY_CRITICAL, function, file, line,
+                       "Memory allocation failed: %zu bytes", size);
+    }
+    return ptr;
+}
+
+static inline void* eh_safe_calloc(size_t count, size_t size, const char* function, const char* file, int line) {
+#ifdef EH_ENABLE_ALLOC_TRACKING
+    void* base = NULL;
+    if (size == 0 || count <= (SIZE_MAX - sizeof(eh_alloc_header_t)) / size) {
+        base = calloc(1, sizeof(eh_alloc_header_t) + count * size);
+    }
+    void* ptr = base ? eh_alloc_attach(base, (uint64_t)count * size,
+                                       eh_alloc_site_id(function, file, line)) : NULL;
+#else
+    void* ptr = calloc(count, size);
+#endif
+    if (!ptr && count > 0 && size > 0) {
+        eh_handle_error(EH_ERROR_MEMORY, EH_SEVERITY_CRITICAL, function, file, line,
+                       "Memory allocation failed: %zu x %zu bytes", count, size);
+    }
+    return ptr;
+}
+
+static inline void* eh_safe_realloc(void* ptr, size_t size, const char* function, const char* file, int line) {
+#ifdef EH_ENABLE_ALLOC_TRACKING
+    if (!ptr) return eh_safe_malloc(size, function, file, line);
+    void* new_ptr = NULL;
+    eh_alloc_header_t* header = eh_alloc_header(ptr);
+    if (!header) {
+        eh_handle_error(EH_ERROR_CORRUPTED_DATA, EH_SEVERITY_ERROR, function, file, line,
+                       "EH_REALLOC of a block not allocated through EH_MALLOC: %p", ptr);
+        return ptr;
+    }
+    eh_alloc_header_t old_header = *header;
+    void* base = size <= SIZE_MAX - sizeof(eh_alloc_header_t) ?
+                 realloc(header, sizeof(eh_alloc_header_t) + size) : NULL;
+    if (base) {
+        /* Charge the old block to its site and the new one to this site */
+        eh_alloc_record(old_header.site, old_header.size, 1);
+        new_ptr = eh_alloc_attach(base, size, eh_alloc_site_id(function, file, line));
+    }
+#else
+    void* new_ptr = realloc(ptr, size);
+#endif
+    if (!new_ptr && size > 0) {
+        eh_handle_error(EH_ERROR_MEMORY, EH_SEVERITY_CRITICAL, function, file, line,
+                       "Memory reallocation failed: %zu bytes", size);
+        return ptr; /* Return original pointer to avoid memory leak */
+    }
+    return new_ptr;
+}
+
+static inline void eh_safe_free(void** ptr) {
+    if (ptr && *ptr) {
+#ifdef EH_ENABLE_ALLOC_TRACKING
+        eh_alloc_header_t* header = eh_alloc_header(*ptr);
+        if (!header) {
+            EH_ERROR(EH_ERROR_CORRUPTED_DATA, "EH_FREE of a block not allocated through EH_MALLOC: %p", *ptr);
+            return;
+        }
+        eh_alloc_record(header->site, header->size, 1);
+        header->magic = 0;
+        free(header);
+#else
+        free(*ptr);
+#endif
+        *ptr = NULL;
+    }
+}
+
+/* File operations with error handling */
+static inline FILE* eh_safe_fopen(const char* filename, const char* mode, 
+                                 const char* function, const char* file, int line) {
+    FILE* fp = fopen(filename, mode);
+    if (!fp) {
+        eh_handle_error(EH_ERROR_FILE_IO, EH_SEVERITY_ERROR, function, file, line,
+                       "Failed to open file '%s' with mode '%s': %s", 
+                       filename, mode, strerror(errno));
+    }
+    return fp;
+}
+
+#define EH_FOPEN(filename, mode) eh_safe_fopen(filename, mode, __FUNCTION__, __FILE__, __LINE__)
+
+/* Arena allocator: bump allocation out of chained blocks, freed all at once.
+ * Not thread-safe; use one arena per thread or per request. Blocks come from
+ * eh_safe_malloc, so out-of-memory is reported (and tracked) like EH_MALLOC. */
+typedef struct eh_arena_block eh_arena_block_t;
+struct eh_arena_block {
+    eh_arena_block_t* next;
+    size_t capacity;
+    size_t used;
+    size_t pad;                 /* keeps data 16-byte aligned */
+};
+
+typedef struct {
+    eh_arena_block_t* first;
+    eh_arena_block_t* current;
+    size_t block_size;
+} eh_arena_t;
+
+#define EH_ARENA_ALLOC(arena, size) \
+    eh_arena_alloc_aligned(arena, size, 16, __FUNCTION__, __FILE__, __LINE__)
+#define EH_ARENA_ALLOC_ALIGNED(arena, size, alignment) \
+    eh_arena_alloc_aligned(arena, size, alignment, __FUNCTION__, __FILE__, __LINE__)
+
+static inline void eh_arena_init(eh_arena_t* arena, size_t block_size) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->block_size = block_size ? block_size : EH_ARENA_BLOCK_SIZE;
+}
+
+/* alignment must be a power of two */
+static inline void* eh_arena_alloc_aligned(eh_arena_t* arena, size_t size, size_t alignment,
+                                           const char* function, const char* file, int line) {
+    eh_arena_block_t* block = arena->current;
+    while (block) {
+        char* data = (char*)(block + 1);
+        size_t offset = (size_t)(((uintptr_t)data + block->used + alignment - 1) & ~(uintptr_t)(alignment - 1)) -
+                        (size_t)(uintptr_t)data;
+        if (offset <= block->capacity && size <= block->capacity - offset) {
+            block->used = offset + size;
+            arena->current = block;
+            return data + offset;
+        }
+        /* Blocks kept by eh_arena_reset are reused before new ones are made */
+        block = block->next;
+        if (block) block->used = 0;
+    }
+    
+    size_t capacity = arena->block_size;
+    if (size > SIZE_MAX - alignment - sizeof(eh_arena_block_t)) {
+        eh_handle_error(EH_ERROR_MEMORY, EH_SEVERITY_CRITICAL, function, file, line,
+                       "Arena allocation too large: %zu bytes", size);
+        return NULL;
+    }
+    if (capacity < size + alignment) capacity = size + alignment;
+    
+    block = (eh_arena_block_t*)eh_safe_malloc(sizeof(eh_arena_block_t) + capacity, function, file, line);
+    if (!block) return NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    
+    /* Link after the current block so the chain keeps its order */
+    if (arena->current) {
+        block->next = arena->current->next;
+        arena->current->next = block;
+    } else {
+        block->next = arena->first;
+        arena->first = block;
+    }
+    arena->current = block;
+    
+    char* data = (char*)(block + 1);
+    size_t offset = (size_t)(((uintptr_t)data + alignment - 1) & ~(uintptr_t)(alignment - 1)) -
+                    (size_t)(uintptr_t)data;
+    block->used = offset + size;
+    return data + offset;
+}
+
+/* Drops every allocation but keeps the blocks for reuse */
+static inline void eh_arena_reset(eh_arena_t* arena) {
+    arena->current = arena->first;
+    if (arena->first) arena->first->used = 0;
+}
+
+static inline void eh_arena_destroy(eh_arena_t* arena) {
+    eh_arena_block_t* block = arena->first;
+    while (block) {
+        eh_arena_block_t* next = block->next;
+        eh_safe_free((void**)&block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+}
+
+/* Pool allocator: fixed-size objects on a free list. Each thread keeps a
+ * small cache of free objects and only takes the pool lock to move a batch
+ * to or from the shared list. */
+typedef struct eh_pool_node eh_pool_node_t;
+struct eh_pool_node {
+    eh_pool_node_t* next;
+};
+
+typedef struct {
+    eh_pool_node_t* head;
+    uint64_t count;
+    char pad[EH_CACHE_LINE_SIZE - sizeof(eh_pool_node_t*) - sizeof(uint64_t)];
+} eh_pool_cache_t;
+
+typedef struct {
+    size_t object_size;
+    volatile uint64_t lock;
+    eh_pool_node_t* free_list;      /* shared, under lock */
+    void* chunks;                   /* heap chunks, chained through their first word */
+    eh_pool_cache_t* caches;        /* one per thread slot, inherited with the slot */
+} eh_pool_t;
+
+#define EH_POOL_ALLOC(pool) eh_pool_alloc_internal(pool, __FUNCTION__, __FILE__, __LINE__)
+#define EH_POOL_FREE(pool, ptr) eh_pool_free(pool, (void**)&(ptr))
+
+static inline void eh_pool_lock(eh_pool_t* pool) {
+    uint64_t expected = 0;
+    while (!eh_atomic_cas(&pool->lock, &expected, 1)) {
+        expected = 0;
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+}
+
+static inline int eh_pool_init(eh_pool_t* pool, size_t object_size) {
+    /* Room for the free-list link, rounded to keep 16-byte alignment */
+    if (object_size < sizeof(eh_pool_node_t)) object_size = sizeof(eh_pool_node_t);
+    pool->object_size = (object_size + 15) & ~(size_t)15;
+    pool->lock = 0;
+    pool->free_list = NULL;
+    pool->chunks = NULL;
+    pool->caches = (eh_pool_cache_t*)EH_CALLOC(EH_MAX_THREADS, sizeof(eh_pool_cache_t));
+    return pool->caches ? EH_SUCCESS : EH_ERROR_MEMORY;
+}
+
+/* Caller holds the lock; carves a new chunk onto the shared list */
+static inline int eh_pool_grow(eh_pool_t* pool, const char* function, const char* file, int line) {
+    size_t header = 16;
+    char* chunk = (char*)eh_safe_malloc(header + pool->object_size * EH_POOL_CHUNK_OBJECTS,
+                                        function, file, line);
+    if (!chunk) return 0;
+    *(void**)chunk = pool->chunks;
+    pool->chunks = chunk;
+    
+    for (size_t i = EH_POOL_CHUNK_OBJECTS; i > 0; i--) {
+        eh_pool_node_t* node = (eh_pool_node_t*)(chunk + header + (i - 1) * pool->object_size);
+        node->next = pool->free_list;
+        pool->free_list = node;
+    }
+    return 1;
+}
+
+/* The calling thread's cache, or NULL when every slot is taken by a live
+ * thread. An exited thread's cached objects go to the next owner of its slot */
+static inline eh_pool_cache_t* eh_pool_thread_cache(eh_pool_t* pool) {
+    uint64_t slot = eh_thread_slot();
+    return slot < EH_MAX_THREADS ? &pool->caches[slot] : NULL;
+}
+
+static inline void* eh_pool_alloc_internal(eh_pool_t* pool, const char* function,
+                                           const char* file, int line) {
+    eh_pool_cache_t* cache = eh_pool_thread_cache(pool);
+    if (cache && cache->head) {
+        eh_pool_node_t* node = cache->head;
+        cache->head = node->next;
+        cache->count--;
+        return node;
+    }
+    
+    eh_pool_lock(pool);
+    if (!pool->free_list && !eh_pool_grow(pool, function, file, line)) {
+        eh_atomic_store(&pool->lock, 0);
+        return NULL;
+    }
+    eh_pool_node_t* node = pool->free_list;
+    pool->free_list = node->next;
+    
+    /* Refill the cache with a batch while the lock is held */
+    if (cache) {
+        for (int i = 0; i < EH_POOL_CACHE_BATCH && pool->free_list; i++) {
+            eh_pool_node_t* next = pool->free_list;
+            pool->free_list = next->next;
+            next->next = cache->head;
+            cache->head = next;
+            cache->count++;
+        }
+    }
+    eh_atomic_store(&pool->lock, 0);
+    return node;
+}
+
+static inline void eh_pool_free(eh_pool_t* pool, void** ptr) {
+    if (!ptr || !*ptr) return;
+    eh_pool_node_t* node = (eh_pool_node_t*)*ptr;
+    *ptr = NULL;
+    
+    eh_pool_cache_t* cache = eh_pool_thread_cache(pool);
+    if (cache) {
+        node->next = cache->head;
+        cache->head = node;
+        if (++cache->count < 2 * EH_POOL_CACHE_BATCH) return;
+        
+        /* Cache is full: hand a batch back to the shared list */
+        eh_pool_node_t* first = cache->head;
+        eh_pool_node_t* last = first;
+        for (int i = 1; i < EH_POOL_CACHE_BATCH; i++) last = last->next;
+        cache->head = last->next;
+        cache->count -= EH_POOL_CACHE_BATCH;
+        
+        eh_pool_lock(pool);
+        last->next = pool->free_list;
+        pool->free_list = first;
+        eh_atomic_store(&pool->lock, 0);
+        return;
+    }
+    
+    eh_pool_lock(pool);
+    node->next = pool->free_list;
+    pool->free_list = node;
+    eh_atomic_store(&pool->lock, 0);
+}
+
+/* Frees every chunk; objects still in use or cached by other threads go with them */
+static inline void eh_pool_destroy(eh_pool_t* pool) {
+    void* chunk = pool->chunks;
+    while (chunk) {
+        void* next = *(void**)chunk;
+        eh_safe_free(&chunk);
+        chunk = next;
+    }
+    pool->chunks = NULL;
+    pool->free_list = NULL;
+    EH_FREE(pool->caches);
+}
+
+/* Windows-specific error handling */
+#ifdef _WIN32
+static inline void eh_handle_win32_error(const char* function, const char* file, int line,
+                                        const char* operation) {
+    DWORD error = GetLastError();
+    if (error != ERROR_SUCCESS) {
+        char* message = NULL;
+        FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM,
+                      NULL, error, 0, (LPSTR)&message, 0, NULL);
+        
+        eh_handle_error(EH_ERROR_SYSTEM_CALL, EH_SEVERITY_ERROR, function, file, line,
+                       "Win32 error in %s: %s (Code: %lu)", 
+                       operation, message ? message : "Unknown error", error);
+        
+        if (message) LocalFree(message);
+    }
+}
+
+#define EH_WIN32_CHECK(operation) \
+    eh_handle_win32_error(__FUNCTION__, __FILE__, __LINE__, #operation)
+#else
+/* POSIX counterpart: report errno after a failed call */
+static inline void eh_handle_errno_error(const char* function, const char* file, int line,
+                                        const char* operation) {
+    int error = errno;
+    if (error != 0) {
+        eh_handle_error(EH_ERROR_SYSTEM_CALL, EH_SEVERITY_ERROR, function, file, line,
+                       "System error in %s: %s (errno: %d)",
+                       operation, strerror(error), error);
+    }
+}
+
+#define EH_ERRNO_CHECK(operation) \
+    eh_handle_errno_error(__FUNCTION__, __FILE__, __LINE__, #operation)
+#endif
+
+/* Utility functions */
+
+/* Last error reported on the calling thread */
+static inline const eh_error_context_t* eh_get_last_error(void) {
+    return &t_eh_last_error;
+}
+
+static inline int eh_get_error_count(void) {
+    return (int)eh_stats_sum(offsetof(eh_thread_stats_t, errors));
+}
+
+static inline int eh_get_warning_count(void) {
+    return (int)eh_stats_sum(offsetof(eh_thread_stats_t, warnings));
+}
+
+/* Writes a summary for every rate-limited site that is still holding records back */
+static inline void eh_rate_limit_flush(void) {
+    for (eh_rate_limit_t* site = g_eh_rate_sites; site; site = site->next) {
+        uint64_t suppressed = eh_atomic_exchange(&site->suppressed, 0);
+        if (suppressed) {
+            eh_handle_error(site->code, site->severity, site->function, site->file, site->line,
+                           "suppressed %llu similar messages", (unsigned long long)suppressed);
+        }
+    }
+}
+
+/* Internal implementation functions */
+static struct tm* eh_localtime(const time_t* timestamp, struct tm* out) {
+#ifdef _WIN32
+    return localtime_s(out, timestamp) == 0 ? out : NULL;
+#else
+    return localtime_r(timestamp, out);
+#endif
+}
+
+static void eh_format_log_line(const eh_error_context_t* context, char* log_line, size_t size) {
+    char timestamp_str[64] = "";
+    struct tm tm_buf;
+    struct tm* tm_info = eh_localtime(&context->timestamp, &tm_buf);
+    if (tm_info) {
+        strftime(timestamp_str, sizeof(timestamp_str), "%Y-%m-%d %H:%M:%S", tm_info);
+    }
+    
+    const char* severity_str = eh_severity_to_string(context->severity);
+    const char* code_str = eh_error_code_to_string(context->code);
+    
+    snprintf(log_line, size,
+            "[%s] %s (%s) in %s() at %s:%d - %s",
+            timestamp_str, severity_str, code_str,
+            context->function, context->file, context->line, context->message);
+    
+#ifdef _WIN32
+    if (context->win32_error != 0) {
+        char win32_msg[512];
+        snprintf(win32_msg, sizeof(win32_msg), " [Win32: %lu]", context->win32_error);
+        strncat(log_line, win32_msg, size - strlen(log_line) - 1);
+    }
+#else
+    if (context->os_errno != 0) {
+        char errno_msg[64];
+        snprintf(errno_msg, sizeof(errno_msg), " [errno: %d]", context->os_errno);
+        strncat(log_line, errno_msg, size - strlen(log_line) - 1);
+    }
+#endif
+}
+
+static void eh_internal_log_sync(const eh_error_context_t* context, int flush) {
+    char log_line[2048];
+    eh_format_log_line(context, log_line, sizeof(log_line));
+    
+    /* Console output */
+    if (g_eh_config.enable_console_output) {
+        FILE* output = (context->severity >= EH_SEVERITY_ERROR) ? stderr : stdout;
+        fprintf(output, "%s\n", log_line);
+        if (flush) fflush(output);
+    }
+    
+    /* Debug output (Windows) */
+#ifdef _WIN32
+    if (g_eh_config.enable_debug_output && IsDebuggerPresent()) {
+        OutputDebugStringA(log_line);
+        OutputDebugStringA("\n");
+    }
+#endif
+    
+    /* File logging */
+    if (eh_log_file_active()) {
+        size_t len = strlen(log_line);
+        if (len + 1 >= sizeof(log_line)) len = sizeof(log_line) - 2;
+        log_line[len] = '\n';
+        log_line[len + 1] = '\0';
+        eh_log_file_write(log_line, context->severity, flush);
+    }
+    
+    if (context->stack_depth > 0) {
+        eh_write_stack_frames(context);
+    }
+}
+
+/* Memory-mapped log file
+ * The file is pre-sized to log_rotate_size and records are copied straight
+ * into the shared mapping, so the page cache keeps them even if the process
+ * dies. On close or rotation the file is truncated to what was written. */
+static void eh_mapped_log_sync(eh_mapped_log_t* log, int wait) {
+#ifdef _WIN32
+    FlushViewOfFile(log->base, log->offset);
+    if (wait) FlushFileBuffers(log->file);
+#else
+    msync(log->base, log->offset ? log->offset : 1, wait ? MS_SYNC : MS_ASYNC);
+#endif
+    log->last_flush_ns = eh_monotonic_ns();
+    log->unsynced = 0;
+}
+
+static int eh_mapped_log_sync_due(const eh_mapped_log_t* log, uint64_t now) {
+    return now - log->last_flush_ns >= (uint64_t)g_eh_config.log_flush_interval_ms * 1000000ULL;
+}
+
+static void eh_mapped_log_unmap(eh_mapped_log_t* log) {
+    if (!log->base) return;
+    eh_mapped_log_sync(log, 1);
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    UnmapViewOfFile(log->base);
+    CloseHandle(log->mapping);
+    size.QuadPart = (LONGLONG)log->offset;
+    SetFilePointerEx(log->file, size, NULL, FILE_BEGIN);
+    SetEndOfFile(log->file);
+    CloseHandle(log->file);
+#else
+    munmap(log->base, log->capacity);
+    if (ftruncate(log->fd, (off_t)log->offset) != 0) { /* keep the padded file */ }
+    close(log->fd);
+#endif
+    log->base = NULL;
+}
+
+/* Shifts path -> path.1 -> path.2 ... dropping the oldest */
+static void eh_mapped_log_shift_files(const char* path, int keep) {
+    char from[600], to[600];
+    if (keep <= 0) {
+        remove(path);
+        return;
+    }
+    for (int i = keep; i >= 1; i--) {
+        if (i > 1) snprintf(from, sizeof(from), "%s.%d", path, i - 1);
+        else snprintf(from, sizeof(from), "%s", path);
+        snprintf(to, sizeof(to), "%s.%d", path, i);
+#ifdef _WIN32
+        MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING);
+#else
+        rename(from, to);
+#endif
+    }
+}
+
+static int eh_mapped_log_map(eh_mapped_log_t* log, const char* path) {
+    size_t existing = 0;
+    
+#ifdef _WIN32
+    log->file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (log->file == INVALID_HANDLE_VALUE) return EH_ERROR_FILE_IO;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(log->file, &size)) existing = (size_t)size.QuadPart;
+    if (existing >= log->capacity) {
+        CloseHandle(log->file);
+        return EH_ERROR_ALREADY_EXISTS;
+    }
+    log->mapping = CreateFileMappingA(log->file, NULL, PAGE_READWRITE,
+                                      (DWORD)((uint64_t)log->capacity >> 32),
+                                      (DWORD)(log->capacity & 0xFFFFFFFFu), NULL);
+    if (!log->mapping) {
+        CloseHandle(log->file);
+        return EH_ERROR_SYSTEM_CALL;
+    }
+    log->base = (char*)MapViewOfFile(log->mapping, FILE_MAP_WRITE, 0, 0, log->capacity);
+    if (!log->base) {
+        CloseHandle(log->mapping);
+        CloseHandle(log->file);
+        return EH_ERROR_SYSTEM_CALL;
+    }
+#else
+    struct stat st;
+    log->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (log->fd < 0) return EH_ERROR_FILE_IO;
+    if (fstat(log->fd, &st) == 0) existing = (size_t)st.st_size;
+    if (existing >= log->capacity) {
+        close(log->fd);
+        return EH_ERROR_ALREADY_EXISTS;
+    }
+    if (ftruncate(log->fd, (off_t)log->capacity) != 0) {
+        close(log->fd);
+        return EH_ERROR_FILE_IO;
+    }
+    void* base = mmap(NULL, log->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, log->fd, 0);
+    if (base == MAP_FAILED) {
+        close(log->fd);
+        return EH_ERROR_SYSTEM_CALL;
+    }
+    log->base = (char*)base;
+#endif
+    
+    /* Append after existing text; a file left padded by a crash ends at the last non-NUL */
+    log->offset = existing;
+    while (log->offset > 0 && log->base[log->offset - 1] == '\0') log->offset--;
+    log->opened_ns = eh_monotonic_ns();
+    log->last_flush_ns = log->opened_ns;
+    return EH_SUCCESS;
+}
+
+static int eh_mapped_log_rotate(eh_mapped_log_t* log) {
+    eh_mapped_log_unmap(log);
+    eh_mapped_log_shift_files(g_eh_config.log_file_path, g_eh_config.log_rotate_keep);
+    return eh_mapped_log_map(log, g_eh_config.log_file_path);
+}
+
+static void eh_spin_lock(volatile uint64_t* lock) {
+    uint64_t expected = 0;
+    while (!eh_atomic_cas(lock, &expected, 1)) {
+        expected = 0;
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+}
+
+static void eh_mapped_log_write(eh_mapped_log_t* log, const char* text, size_t len,
+                                eh_severity_t severity, int flush) {
+    eh_spin_lock(&log->lock);
+    
+    uint64_t now = eh_monotonic_ns();
+    int expired = g_eh_config.log_rotate_interval_s > 0 &&
+                  now - log->opened_ns >= (uint64_t)g_eh_config.log_rotate_interval_s * 1000000000ULL;
+    if (log->base && (expired || log->offset + len > log->capacity)) {
+        eh_mapped_log_rotate(log);
+    }
+    
+    if (log->base) {
+        if (len > log->capacity - log->offset) len = log->capacity - log->offset;
+        memcpy(log->base + log->offset, text, len);
+        log->offset += len;
+        log->unsynced = 1;
+        
+        if (severity >= EH_SEVERITY_CRITICAL || severity >= g_eh_config.log_flush_severity) {
+            eh_mapped_log_sync(log, 1);
+        } else if (flush && eh_mapped_log_sync_due(log, now)) {
+            eh_mapped_log_sync(log, 0);
+        }
+    }
+    
+    eh_atomic_store(&log->lock, 0);
+}
+
+/* Interval msync for the async writer, which writes records with flush = 0:
+ * after each batch and while idle, so the last records don't wait for more */
+static void eh_mapped_log_sync_if_due(eh_mapped_log_t* log) {
+    eh_spin_lock(&log->lock);
+    if (log->base && log->unsynced && eh_mapped_log_sync_due(log, eh_monotonic_ns())) {
+        eh_mapped_log_sync(log, 0);
+    }
+    eh_atomic_store(&log->lock, 0);
+}
+
+/* Log file routing: the mapped writer when enabled, the stdio handle otherwise */
+static void eh_log_file_open(void) {
+    if (g_eh_config.enable_mapped_log) {
+        if (g_eh_mapped_log) return;
+        eh_mapped_log_t* log = (eh_mapped_log_t*)calloc(1, sizeof(eh_mapped_log_t));
+        if (!log) return;
+        log->capacity = g_eh_config.log_rotate_size ? g_eh_config.log_rotate_size : EH_LOG_ROTATE_SIZE;
+        int status = eh_mapped_log_map(log, g_eh_config.log_file_path);
+        if (status == EH_ERROR_ALREADY_EXISTS) {
+            /* Previous file is already full */
+            eh_mapped_log_shift_files(g_eh_config.log_file_path, g_eh_config.log_rotate_keep);
+            status = eh_mapped_log_map(log, g_eh_config.log_file_path);
+        }
+        if (status != EH_SUCCESS) {
+            free(log);
+            return;
+        }
+        g_eh_mapped_log = log;
+    } else if (!g_eh_config.log_file_handle) {
+        g_eh_config.log_file_handle = fopen(g_eh_config.log_file_path, "a");
+    }
+}
+
+static void eh_log_file_close(void) {
+    if (g_eh_mapped_log) {
+        eh_mapped_log_unmap(g_eh_mapped_log);
+        free(g_eh_mapped_log);
+        g_eh_mapped_log = NULL;
+    }
+    if (g_eh_config.log_file_handle) {
+        fclose(g_eh_config.log_file_handle);
+        g_eh_config.log_file_handle = NULL;
+    }
+}
+
+static int eh_log_file_active(void) {
+    return g_eh_config.enable_logging && (g_eh_mapped_log || g_eh_config.log_file_handle);
+}
+
+static void eh_log_file_write(const char* text, eh_severity_t severity, int flush) {
+    if (g_eh_mapped_log) {
+        eh_mapped_log_write(g_eh_mapped_log, text, strlen(text), severity, flush);
+    } else if (g_eh_config.log_file_handle) {
+        fputs(text, g_eh_config.log_file_handle);
+        if (flush) fflush(g_eh_config.log_file_handle);
+    }
+}
+
+/* Push a record onto the async queue; returns 0 if the caller must log it itself */
+static int eh_async_enqueue(const eh_error_context_t* context) {
+    const uint64_t mask = EH_ASYNC_QUEUE_SIZE - 1;
+    int queued = 0;
+    
+    if (!eh_atomic_load(&g_eh_async.running)) return 0;
+    
+    /* Registering as a producer keeps eh_async_stop from freeing the ring under us */
+    eh_atomic_fetch_add(&g_eh_async.active_producers, 1);
+    
+    uint64_t pos = eh_atomic_load(&g_eh_async.enqueue_pos);
+    while (eh_atomic_load(&g_eh_async.running)) {
+        eh_async_slot_t* slot = &g_eh_async.slots[pos & mask];
+        int64_t diff = (int64_t)(eh_atomic_load(&slot->sequence) - pos);
+        
+        if (diff == 0) {
+            if (eh_atomic_cas(&g_eh_async.enqueue_pos, &pos, pos + 1)) {
+                slot->context = *context;
+                eh_atomic_store(&slot->sequence, pos + 1);
+                queued = 1;
+                break;
+            }
+        } else if (diff < 0) {
+            /* Queue is full */
+            if (g_eh_config.async_overflow_policy == EH_ASYNC_DROP) {
+                eh_atomic_fetch_add(&g_eh_async.dropped, 1);
+                queued = 1;
+                break;
+            }
+#ifdef _WIN32
+            SwitchToThread();
+#else
+            sched_yield();
+#endif
+            pos = eh_atomic_load(&g_eh_async.enqueue_pos);
+        } else {
+            pos = eh_atomic_load(&g_eh_async.enqueue_pos);
+        }
+    }
+    
+    eh_atomic_fetch_add(&g_eh_async.active_producers, (uint64_t)0 - 1);
+    return queued;
+}
+
+/* Format and write up to one batch of queued records, then flush once */
+static size_t eh_async_drain_batch(void) {
+    const uint64_t mask = EH_ASYNC_QUEUE_SIZE - 1;
+    size_t written = 0;
+    
+    while (written < EH_ASYNC_BATCH_SIZE) {
+        uint64_t pos = g_eh_async.dequeue_pos;
+        eh_async_slot_t* slot = &g_eh_async.slots[pos & mask];
+        if (eh_atomic_load(&slot->sequence) != pos + 1) break;
+        
+        eh_internal_log_sync(&slot->context, 0);
+        
+        eh_atomic_store(&slot->sequence, pos + EH_ASYNC_QUEUE_SIZE);
+        g_eh_async.dequeue_pos = pos + 1;
+        written++;
+    }
+    
+    uint64_t dropped = eh_atomic_load(&g_eh_async.dropped);
+    if (dropped) {
+        eh_atomic_fetch_add(&g_eh_async.dropped, (uint64_t)0 - dropped);
+        if (eh_log_file_active()) {
+            char notice[96];
+            snprintf(notice, sizeof(notice), "=== Async queue full: dropped %llu records ===\n",
+                    (unsigned long long)dropped);
+            eh_log_file_write(notice, EH_SEVERITY_WARNING, 0);
+        }
+        written++;
+    }
+    
+    if (written) {
+        if (g_eh_config.enable_console_output) {
+            fflush(stdout);
+            fflush(stderr);
+        }
+        if (g_eh_config.log_file_handle) {
+            fflush(g_eh_config.log_file_handle);
+        }
+    }
+    if (g_eh_mapped_log) eh_mapped_log_sync_if_due(g_eh_mapped_log);
+    return written;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI eh_async_writer_main(LPVOID arg) {
+#else
+static void* eh_async_writer_main(void* arg) {
+#endif
+    (void)arg;
+    for (;;) {
+        int stopping = eh_atomic_load(&g_eh_async.stop_requested) != 0;
+        if (eh_async_drain_batch() > 0) continue;
+        if (stopping) break;
+#ifdef _WIN32
+        Sleep(EH_ASYNC_IDLE_SLEEP_US / 1000 ? EH_ASYNC_IDLE_SLEEP_US / 1000 : 1);
+#else
+        struct timespec ts = {0, EH_ASYNC_IDLE_SLEEP_US * 1000L};
+        nanosleep(&ts, NULL);
+#endif
+    }
+    return 0;
+}
+
+static int eh_async_start(void) {
+    if (g_eh_async.running) return EH_SUCCESS;
+    
+    if (!g_eh_async.slots) {
+        g_eh_async.slots = (eh_async_slot_t*)malloc(sizeof(eh_async_slot_t) * EH_ASYNC_QUEUE_SIZE);
+        if (!g_eh_async.slots) return EH_ERROR_MEMORY;
+    }
+    for (uint64_t i = 0; i < EH_ASYNC_QUEUE_SIZE; i++) {
+        g_eh_async.slots[i].sequence = i;
+    }
+    g_eh_async.enqueue_pos = 0;
+    g_eh_async.dequeue_pos = 0;
+    g_eh_async.dropped = 0;
+    g_eh_async.stop_requested = 0;
+    
+#ifdef _WIN32
+    g_eh_async.writer = CreateThread(NULL, 0, eh_async_writer_main, NULL, 0, NULL);
+    if (!g_eh_async.writer) return EH_ERROR_SYSTEM_CALL;
+#else
+    if (pthread_create(&g_eh_async.writer, NULL, eh_async_writer_main, NULL) != 0) {
+        return EH_ERROR_SYSTEM_CALL;
+    }
+#endif
+    
+    eh_atomic_store(&g_eh_async.running, 1);
+    return EH_SUCCESS;
+}
+
+static void eh_async_stop(void) {
+    if (!g_eh_async.running) return;
+    
+    /* Stop accepting records, wait out in-flight producers, then drain */
+    eh_atomic_fetch_add(&g_eh_async.running, (uint64_t)0 - 1);
+    while (eh_atomic_load(&g_eh_async.active_producers) != 0) {
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+    eh_atomic_store(&g_eh_async.stop_requested, 1);
+    
+#ifdef _WIN32
+    WaitForSingleObject(g_eh_async.writer, INFINITE);
+    CloseHandle(g_eh_async.writer);
+#else
+    pthread_join(g_eh_async.writer, NULL);
+#endif
+    
+    free(g_eh_async.slots);
+    g_eh_async.slots = NULL;
+}
+
+static void eh_internal_log(const eh_error_context_t* context) {
+    if (eh_async_enqueue(context)) return;
+    eh_internal_log_sync(context, 1);
+}
+
+/* Binary log
+ * File layout: "EHBLOG01", u64 tsc, i64 wall clock ns, then records of
+ * u8 type + u16 body length + body. Strings (formats, function and file
+ * names) are sent once as STRING records and referenced by id after that. */
+#define EH_BINLOG_MAGIC "EHBLOG01"
+
+enum {
+    EH_BINLOG_STRING = 1,   /* u32 id, bytes */
+    EH_BINLOG_RECORD = 2,   /* i32 code, u8 severity, i32 line, u64 tsc, u32 fmt/func/file ids, args */
+    EH_BINLOG_SYNC = 3      /* u64 tsc, i64 wall clock ns */
+};
+
+/* Argument tags; integers are zigzag/LEB128 varints */
+enum {
+    EH_BINARG_INT = 'i',
+    EH_BINARG_UINT = 'u',
+    EH_BINARG_DOUBLE = 'd',
+    EH_BINARG_STRING = 's',
+    EH_BINARG_POINTER = 'p'
+};
+
+/* Used when a format cannot be encoded: the message is stored pre-formatted */
+static const char eh_binlog_raw_format[] = "%s";
+
+static inline uint64_t eh_read_tsc(void) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline int64_t eh_wall_time_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* One parsed printf conversion specification */
+typedef struct {
+    const char* flags;      /* points at the flag characters after '%' */
+    size_t flags_len;
+    int width_star;
+    const char* width;
+    size_t width_len;
+    int has_precision;
+    int precision_star;
+    const char* precision;
+    size_t precision_len;
+    char length;            /* 0, 'H' (hh), 'h', 'l', 'q' (ll), 'L', 'z', 'j', 't' */
+    char conversion;
+} eh_binlog_spec_t;
+
+/* Parses the spec starting right after '%'; returns 0 on specs we do not support */
+static int eh_binlog_parse_spec(const char** cursor, eh_binlog_spec_t* spec) {
+    const char* f = *cursor;
+    memset(spec, 0, sizeof(*spec));
+    
+    spec->flags = f;
+    while (*f && strchr("-+ #0", *f)) f++;
+    spec->flags_len = (size_t)(f - spec->flags);
+    
+    if (*f == '*') {
+        spec->width_star = 1;
+        f++;
+    } else {
+        spec->width = f;
+        while (*f >= '0' && *f <= '9') f++;
+        spec->width_len = (size_t)(f - spec->width);
+        if (*f == '$') return 0; /* positional arguments */
+    }
+    
+    if (*f == '.') {
+        spec->has_precision = 1;
+        f++;
+        if (*f == '*') {
+            spec->precision_star = 1;
+            f++;
+        } else {
+            spec->precision = f;
+            while (*f >= '0' && *f <= '9') f++;
+            spec->precision_len = (size_t)(f - spec->precision);
+        }
+    }
+    
+    switch (*f) {
+        case 'h': f++; if (*f == 'h') { spec->length = 'H'; f++; } else spec->length = 'h'; break;
+        case 'l': f++; if (*f == 'l') { spec->length = 'q'; f++; } else spec->length = 'l'; break;
+        case 'L': case 'z': case 'j': case 't': spec->length = *f++; break;
+        default: break;
+    }
+    
+    spec->conversion = *f;
+    if (!strchr("diucoxXfFeEgGaAspn%", *f) || (*f == '\0')) return 0;
+    if ((*f == 's' || *f == 'c') && spec->length == 'l') return 0; /* wide strings */
+    
+    *cursor = f;
+    return 1;
+}
+
+static inline int eh_binlog_put_varint(unsigned char* out, size_t* used, size_t cap, uint64_t value) {
+    do {
+        if (*used >= cap) return 0;
+        unsigned char byte = (unsigned char)(value & 0x7F);
+        value >>= 7;
+        out[(*used)++] = (unsigned char)(byte | (value ? 0x80 : 0));
+    } while (value);
+    return 1;
+}
+
+static inline int eh_binlog_put_int(unsigned char* out, size_t* used, size_t cap, int64_t value) {
+    if (*used >= cap) return 0;
+    out[(*used)++] = EH_BINARG_INT;
+    return eh_binlog_put_varint(out, used, cap, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static inline int eh_binlog_put_uint(unsigned char* out, size_t* used, size_t cap, char tag, uint64_t value) {
+    if (*used >= cap) return 0;
+    out[(*used)++] = (unsigned char)tag;
+    return eh_binlog_put_varint(out, used, cap, value);
+}
+
+/* Copies the printf arguments as typed raw values; returns 0 if the format is unsupported */
+static int eh_binlog_encode_args(const char* format, va_list args, unsigned char* out,
+                                 size_t cap, size_t* out_len) {
+    size_t used = 0;
+    
+    for (const char* f = format; *f; f++) {
+        if (*f != '%') continue;
+        f++;
+        
+        eh_binlog_spec_t spec;
+        if (!eh_binlog_parse_spec(&f, &spec)) return 0;
+        
+        if (spec.width_star && !eh_binlog_put_int(out, &used, cap, va_arg(args, int))) return 0;
+        
+        /* Negative means no precision, as printf treats a negative '*' argument */
+        int precision = -1;
+        if (spec.precision_star) {
+            precision = va_arg(args, int);
+            if (!eh_binlog_put_int(out, &used, cap, precision)) return 0;
+        } else if (spec.has_precision) {
+            precision = 0;
+            for (size_t i = 0; i < spec.precision_len && precision < 100000000; i++) {
+                precision = precision * 10 + (spec.precision[i] - '0');
+            }
+        }
+        
+        int ok = 1;
+        switch (spec.conversion) {
+            case '%':
+                break;
+            case 'd': case 'i': case 'c': {
+                int64_t value;
+                switch (spec.length) {
+                    case 'H': value = (signed char)va_arg(args, int); break;
+                    case 'h': value = (short)va_arg(args, int); break;
+                    case 'l': value = va_arg(args, long); break;
+                    case 'q': value = va_arg(args, long long); break;
+                    case 'z': value = (int64_t)va_arg(args, size_t); break;
+                    case 'j': value = va_arg(args, intmax_t); break;
+                    case 't': value = va_arg(args, ptrdiff_t); break;
+                    default: value = va_arg(args, int); break;
+                }
+                ok = eh_binlog_put_int(out, &used, cap, value);
+                break;
+            }
+            case 'u': case 'o': case 'x': case 'X': {
+                uint64_t value;
+                switch (spec.length) {
+                    case 'H': value = (unsigned char)va_arg(args, unsigned int); break;
+                    case 'h': value = (unsigned short)va_arg(args, unsigned int); break;
+                    case 'l': value = va_arg(args, unsigned long); break;
+                    case 'q': value = va_arg(args, unsigned long long); break;
+                    case 'z': value = va_arg(args, size_t); break;
+                    case 'j': value = va_arg(args, uintmax_t); break;
+                    case 't': value = (uint64_t)va_arg(args, ptrdiff_t); break;
+                    default: value = va_arg(args, unsigned int); break;
+                }
+                ok = eh_binlog_put_uint(out, &used, cap, EH_BINARG_UINT, value);
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                double value = spec.length == 'L' ? (double)va_arg(args, long double)
+                                                  : va_arg(args, double);
+                if (used + 1 + sizeof(value) > cap) return 0;
+                out[used++] = EH_BINARG_DOUBLE;
+                memcpy(out + used, &value, sizeof(value));
+                used += sizeof(value);
+                break;
+            }
+            case 's': {
+                const char* str = va_arg(args, const char*);
+                if (!str) str = "(null)";
+                /* With a precision the argument need not be NUL-terminated */
+                size_t len;
+                if (precision >= 0) {
+                    const char* end = (const char*)memchr(str, '\0', (size_t)precision);
+                    len = end ? (size_t)(end - str) : (size_t)precision;
+                } else {
+                    len = strlen(str);
+                }
+                /* Truncate like the text message would; tag and varint take at most 11 bytes */
+                size_t room = cap - used > 11 ? cap - used - 11 : 0;
+                if (len > room) len = room;
+                if (!eh_binlog_put_uint(out, &used, cap, EH_BINARG_STRING, len)) return 0;
+                memcpy(out + used, str, len);
+                used += len;
+                break;
+            }
+            case 'p':
+                ok = eh_binlog_put_uint(out, &used, cap, EH_BINARG_POINTER,
+                                        (uint64_t)(uintptr_t)va_arg(args, void*));
+                break;
+            case 'n':
+                (void)va_arg(args, void*); /* never written through */
+                break;
+        }
+        if (!ok) return 0;
+    }
+    
+    *out_len = used;
+    return 1;
+}
+
+static inline void eh_binlog_lock(eh_binlog_t* log) {
+    eh_spin_lock(&log->lock);
+}
+
+static inline void eh_binlog_unlock(eh_binlog_t* log) {
+    eh_atomic_store(&log->lock, 0);
+}
+
+static void eh_binlog_put_header(eh_binlog_t* log, unsigned char type, size_t body_len) {
+    uint16_t len16 = (uint16_t)body_len;
+    log->buffer[log->used++] = type;
+    memcpy(log->buffer + log->used, &len16, sizeof(len16));
+    log->used += sizeof(len16);
+}
+
+/* Writes the buffered records followed by a clock sync point; caller holds the lock */
+static void eh_binlog_flush_locked(eh_binlog_t* log) {
+    uint64_t tsc = eh_read_tsc();
+    int64_t wall = eh_wall_time_ns();
+    
+    eh_binlog_put_header(log, EH_BINLOG_SYNC, sizeof(tsc) + sizeof(wall));
+    memcpy(log->buffer + log->used, &tsc, sizeof(tsc));
+    log->used += sizeof(tsc);
+    memcpy(log->buffer + log->used, &wall, sizeof(wall));
+    log->used += sizeof(wall);
+    
+    fwrite(log->buffer, 1, log->used, log->file);
+    fflush(log->file);
+    log->used = 0;
+}
+
+/* Room for the trailing SYNC record that every flush appends */
+#define EH_BINLOG_SYNC_RESERVE (3 + 16)
+
+static void eh_binlog_reserve_locked(eh_binlog_t* log, size_t size) {
+    if (log->used + size + EH_BINLOG_SYNC_RESERVE > sizeof(log->buffer)) {
+        eh_binlog_flush_locked(log);
+    }
+}
+
+/* Longest string a STRING record carries */
+#define EH_BINLOG_STRING_MAX 4096
+
+/* The pointer only finds the slot; the text decides, so a format built in a
+ * reused buffer gets a new id whenever its contents change */
+static uint32_t eh_binlog_intern_locked(eh_binlog_t* log, const char* str) {
+    const size_t mask = EH_BINLOG_STRING_SLOTS - 1;
+    size_t home = (size_t)(((uint64_t)(uintptr_t)str * 0x9E3779B97F4A7C15ULL) >> 40) & mask;
+    size_t slot = home;
+    
+    for (size_t probe = 0; probe < 8; probe++) {
+        size_t idx = (home + probe) & mask;
+        if (log->string_keys[idx] == str) {
+            if (strncmp(log->string_text[idx], str, EH_BINLOG_STRING_MAX) == 0) {
+                return log->string_ids[idx];
+            }
+            slot = idx; /* same buffer, new text */
+            break;
+        }
+        if (!log->string_keys[idx]) {
+            slot = idx;
+            break;
+        }
+    }
+    
+    size_t len = strlen(str);
+    if (len > EH_BINLOG_STRING_MAX) len = EH_BINLOG_STRING_MAX;
+    
+    /* New string, or evicting a slot; the decoder just remaps the id */
+    uint32_t id = log->next_string_id++;
+    free(log->string_text[slot]);
+    log->string_text[slot] = (char*)malloc(len + 1);
+    if (log->string_text[slot]) {
+        memcpy(log->string_text[slot], str, len);
+        log->string_text[slot][len] = '\0';
+        log->string_keys[slot] = str;
+        log->string_ids[slot] = id;
+    } else {
+        log->string_keys[slot] = NULL; /* not cached; written again next time */
+    }
+    
+    eh_binlog_reserve_locked(log, 3 + sizeof(id) + len);
+    eh_binlog_put_header(log, EH_BINLOG_STRING, sizeof(id) + len);
+    memcpy(log->buffer + log->used, &id, sizeof(id));
+    log->used += sizeof(id);
+    memcpy(log->buffer + log->used, str, len);
+    log->used += len;
+    return id;
+}
+
+static void eh_binlog_write(eh_error_code_t code, eh_severity_t severity, const char* function,
+                            const char* file, int line, const char* format, va_list args) {
+    /* Registering as a producer keeps eh_binlog_close from freeing the log under us */
+    eh_atomic_fetch_add(&g_eh_binlog_producers, 1);
+    if (!eh_atomic_load(&g_eh_binlog_active)) {
+        eh_atomic_fetch_add(&g_eh_binlog_producers, (uint64_t)0 - 1);
+        return;
+    }
+    eh_binlog_t* log = g_eh_binlog;
+    unsigned char arg_bytes[EH_BINLOG_MAX_ARGS_SIZE];
+    size_t arg_len = 0;
+    uint64_t tsc = eh_read_tsc();
+    
+    /* Encode outside the lock; fall back to pre-formatted text for odd formats */
+    va_list encode_args;
+    va_copy(encode_args, args);
+    int encoded = eh_binlog_encode_args(format, encode_args, arg_bytes, sizeof(arg_bytes), &arg_len);
+    va_end(encode_args);
+    if (!encoded) {
+        char message[EH_MAX_ERROR_MSG_SIZE];
+        vsnprintf(message, sizeof(message), format, args);
+        size_t len = strlen(message);
+        arg_len = 0;
+        eh_binlog_put_uint(arg_bytes, &arg_len, sizeof(arg_bytes), EH_BINARG_STRING, len);
+        if (len > sizeof(arg_bytes) - arg_len) len = sizeof(arg_bytes) - arg_len;
+        memcpy(arg_bytes + arg_len, message, len);
+        arg_len += len;
+        format = eh_binlog_raw_format;
+    }
+    
+    int32_t code32 = (int32_t)code;
+    int32_t line32 = (int32_t)line;
+    size_t body_len = sizeof(code32) + 1 + sizeof(line32) + sizeof(tsc) + 3 * sizeof(uint32_t) + arg_len;
+    
+    eh_binlog_lock(log);
+    
+    uint32_t ids[3];
+    ids[0] = eh_binlog_intern_locked(log, format);
+    ids[1] = eh_binlog_intern_locked(log, function ? function : "unknown");
+    ids[2] = eh_binlog_intern_locked(log, file ? file : "unknown");
+    
+    eh_binlog_reserve_locked(log, 3 + body_len);
+    eh_binlog_put_header(log, EH_BINLOG_RECORD, body_len);
+    unsigned char* out = log->buffer + log->used;
+    memcpy(out, &code32, sizeof(code32)); out += sizeof(code32);
+    *out++ = (unsigned char)severity;
+    memcpy(out, &line32, sizeof(line32)); out += sizeof(line32);
+    memcpy(out, &tsc, sizeof(tsc)); out += sizeof(tsc);
+    memcpy(out, ids, sizeof(ids)); out += sizeof(ids);
+    memcpy(out, arg_bytes, arg_len);
+    log->used += body_len;
+    
+    /* Do not sit on records that precede a likely crash */
+    if (severity >= EH_SEVERITY_CRITICAL) {
+        eh_binlog_flush_locked(log);
+    }
+    
+    eh_binlog_unlock(log);
+    eh_atomic_fetch_add(&g_eh_binlog_producers, (uint64_t)0 - 1);
+}
+
+static int eh_binlog_open(const char* path) {
+    if (g_eh_binlog) return EH_SUCCESS;
+    
+    eh_binlog_t* log = (eh_binlog_t*)calloc(1, sizeof(eh_binlog_t));
+    if (!log) return EH_ERROR_MEMORY;
+    
+    log->file = fopen(path, "wb");
+    if (!log->file) {
+        free(log);
+        return EH_ERROR_FILE_IO;
+    }
+    
+    uint64_t tsc = eh_read_tsc();
+    int64_t wall = eh_wall_time_ns();
+    fwrite(EH_BINLOG_MAGIC, 1, 8, log->file);
+    fwrite(&tsc, sizeof(tsc), 1, log->file);
+    fwrite(&wall, sizeof(wall), 1, log->file);
+    
+    g_eh_binlog = log;
+    eh_atomic_store(&g_eh_binlog_active, 1);
+    return EH_SUCCESS;
+}
+
+static void eh_binlog_close(void) {
+    eh_binlog_t* log = g_eh_binlog;
+    if (!log) return;
+    
+    /* Stop accepting records and wait out in-flight writers before freeing */
+    eh_atomic_fetch_add(&g_eh_binlog_active, (uint64_t)0 - 1);
+    while (eh_atomic_load(&g_eh_binlog_producers) != 0) {
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+    g_eh_binlog = NULL;
+    
+    eh_binlog_lock(log);
+    eh_binlog_flush_locked(log);
+    eh_binlog_unlock(log);
+    fclose(log->file);
+    for (size_t i = 0; i < EH_BINLOG_STRING_SLOTS; i++) {
+        free(log->string_text[i]);
+    }
+    free(log);
+}
+
+/* Records raw return addresses; cheap enough to run on every ERROR */
+static int eh_capture_stack(void** frames, int max_frames, int skip) {
+#ifdef _WIN32
+    return (int)RtlCaptureStackBackTrace((DWORD)(skip + 1), (DWORD)max_frames, frames, NULL);
+#elif defined(EH_STACK_FRAME_POINTERS) && defined(__GNUC__)
+    /* Frame-pointer walk (build with -fno-omit-frame-pointer) */
+    void** fp = (void**)__builtin_frame_address(0);
+    int count = 0;
+    while (fp && count < max_frames + skip) {
+        void** next = (void**)fp[0];
+        void* ret = fp[1];
+        if (!ret) break;
+        if (count >= skip) frames[count - skip] = ret;
+        count++;
+        /* Frames must move up the stack and stay reasonably close together */
+        if (next <= fp || (char*)next - (char*)fp > (1 << 20) || ((uintptr_t)next & (sizeof(void*) - 1))) break;
+        fp = next;
+    }
+    return count > skip ? count - skip : 0;
+#elif defined(EH_HAVE_EXECINFO)
+    void* raw[EH_MAX_STACK_FRAMES + 8];
+    int limit = max_frames + skip + 1;
+    if (limit > (int)(sizeof(raw) / sizeof(raw[0]))) limit = (int)(sizeof(raw) / sizeof(raw[0]));
+    int count = backtrace(raw, limit) - (skip + 1);
+    if (count <= 0) return 0;
+    if (count > max_frames) count = max_frames;
+    memcpy(frames, raw + skip + 1, (size_t)count * sizeof(void*));
+    return count;
+#else
+    (void)frames; (void)max_frames; (void)skip;
+    return 0;
+#endif
+}
+
+/* Resolves one address to "function() at file:line" style text */
+static void eh_symbolize_uncached(void* address, char* out, size_t size) {
+#ifdef _WIN32
+    HANDLE process = GetCurrentProcess();
+    char symbol_buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME * sizeof(TCHAR)];
+    PSYMBOL_INFO symbol = (PSYMBOL_INFO)symbol_buffer;
+    symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+    symbol->MaxNameLen = MAX_SYM_NAME;
+    
+    DWORD64 displacement = 0;
+    if (SymFromAddr(process, (DWORD64)(uintptr_t)address, &displacement, symbol)) {
+        IMAGEHLP_LINE64 line;
+        DWORD line_displacement = 0;
+        line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+        
+        if (SymGetLineFromAddr64(process, (DWORD64)(uintptr_t)address, &line_displacement, &line)) {
+            snprintf(out, size, "%s() at %s:%lu", symbol->Name, line.FileName, line.LineNumber);
+        } else {
+            snprintf(out, size, "%s()", symbol->Name);
+        }
+        return;
+    }
+#elif defined(EH_HAVE_EXECINFO)
+    char** symbols = backtrace_symbols(&address, 1);
+    if (symbols) {
+        eh_copy_string(out, size, symbols[0]);
+        free(symbols);
+        return;
+    }
+#else
+    (void)address;
+#endif
+    eh_copy_string(out, size, "<unknown>");
+}
+
+/* Cached symbolization; repeated traces from the same sites cost a lookup */
+static void eh_symbolize(void* address, char* out, size_t size) {
+    const size_t mask = EH_SYMBOL_CACHE_SIZE - 1;
+    size_t slot = (size_t)(((uint64_t)(uintptr_t)address * 0x9E3779B97F4A7C15ULL) >> 40) & mask;
+    
+    eh_spin_lock(&g_eh_symbols.lock);
+    if (!g_eh_symbols.entries) {
+        g_eh_symbols.entries = (eh_symbol_entry_t*)calloc(EH_SYMBOL_CACHE_SIZE, sizeof(eh_symbol_entry_t));
+    }
+    eh_symbol_entry_t* entry = g_eh_symbols.entries ? &g_eh_symbols.entries[slot] : NULL;
+    if (entry && entry->address == address) {
+        eh_copy_string(out, size, entry->name);
+    } else {
+        eh_symbolize_uncached(address, out, size);
+        if (entry) {
+            entry->address = address;
+            eh_copy_string(entry->name, sizeof(entry->name), out);
+        }
+    }
+    eh_atomic_store(&g_eh_symbols.lock, 0);
+}
+
+/* Writes the captured frames of a record to the console and log file */
+static void eh_write_stack_frames(const eh_error_context_t* context) {
+    for (int i = 0; i < context->stack_depth; i++) {
+        char name[256];
+        char frame_line[320];
+        eh_symbolize(context->stack_frames[i], name, sizeof(name));
+        snprintf(frame_line, sizeof(frame_line), "  #%d: %s (0x%016llX)\n",
+                i, name, (unsigned long long)(uintptr_t)context->stack_frames[i]);
+        
+        if (g_eh_config.enable_console_output) {
+            fputs(frame_line, stderr);
+        }
+        if (eh_log_file_active()) {
+            eh_log_file_write(frame_line, context->severity, 0);
+        }
+    }
+}
+
+static void eh_print_stack_trace(void) {
+    if (!g_eh_config.enable_stack_trace) return;
+    
+    void* frames[EH_MAX_STACK_FRAMES];
+    int depth = eh_capture_stack(frames, EH_MAX_STACK_FRAMES, 1);
+    
+    if (g_eh_config.enable_console_output) {
+        fprintf(stderr, "\n=== Stack Trace ===\n");
+        for (int i = 0; i < depth; i++) {
+            char name[256];
+            eh_symbolize(frames[i], name, sizeof(name));
+            fprintf(stderr, "  #%d: %s (0x%016llX)\n", i, name, (unsigned long long)(uintptr_t)frames[i]);
+        }
+        fprintf(stderr, "===================\n\n");
+    }
+}
+
+static const char* eh_severity_to_string(eh_severity_t severity) {
+    switch (severity) {
+        case EH_SEVERITY_INFO: return "INFO";
+        case EH_SEVERITY_WARNING: return "WARN";
+        case EH_SEVERITY_ERROR: return "ERROR";
+        case EH_SEVERITY_CRITICAL: return "CRITICAL";
+        case EH_SEVERITY_PANIC: return "PANIC";
+        default: return "UNKNOWN";
+    }
+}
+
+static const char* eh_error_code_to_string(eh_error_code_t code) {
+    switch (code) {
+        case EH_SUCCESS: return "SUCCESS";
+        case EH_ERROR_GENERIC: return "GENERIC";
+        case EH_ERROR_MEMORY: return "MEMORY";
+        case EH_ERROR_FILE_IO: return "FILE_IO";
+        case EH_ERROR_INVALID_PARAM: return "INVALID_PARAM";
+        case EH_ERROR_NETWORK: return "NETWORK";
+        case EH_ERROR_TIMEOUT: return "TIMEOUT";
+        case EH_ERROR_ACCESS_DENIED: return "ACCESS_DENIED";
+        case EH_ERROR_NOT_FOUND: return "NOT_FOUND";
+        case EH_ERROR_ALREADY_EXISTS: return "ALREADY_EXISTS";
+        case EH_ERROR_CORRUPTED_DATA: return "CORRUPTED_DATA";
+        case EH_ERROR_SYSTEM_CALL: return "SYSTEM_CALL";
+        default: return "UNKNOWN";
+    }
+}
+
+/* Offline decoder: turns a binary log back into the usual text lines */
+static inline int eh_binlog_read_varint(const unsigned char** p, const unsigned char* end, uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+        unsigned char byte = *(*p)++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Re-runs the format using the stored arguments */
+static inline int eh_binlog_format_message(const char* format, const unsigned char* args,
+                                           const unsigned char* end, char* out, size_t size) {
+    size_t used = 0;
+    out[0] = '\0';
+    
+    for (const char* f = format; *f && used + 1 < size; f++) {
+        if (*f != '%') {
+            out[used++] = *f;
+            out[used] = '\0';
+            continue;
+        }
+        f++;
+        
+        eh_binlog_spec_t spec;
+        if (!eh_binlog_parse_spec(&f, &spec)) return 0;
+        if (spec.conversion == '%') {
+            out[used++] = '%';
+            out[used] = '\0';
+            continue;
+        }
+        if (spec.conversion == 'n') continue;
+        
+        /* Rebuild the spec with explicit width/precision and a 64-bit length */
+        char spec_str[64];
+        size_t n = 0;
+        uint64_t raw;
+        spec_str[n++] = '%';
+        memcpy(spec_str + n, spec.flags, spec.flags_len < 8 ? spec.flags_len : 8);
+        n += spec.flags_len < 8 ? spec.flags_len : 8;
+        if (spec.width_star) {
+            if (end - args < 1 || *args++ != EH_BINARG_INT || !eh_binlog_read_varint(&args, end, &raw)) return 0;
+            n += (size_t)snprintf(spec_str + n, sizeof(spec_str) - n, "%d", (int)(int64_t)((raw >> 1) ^ (0 - (raw & 1))));
+        } else if (spec.width_len < 16) {
+            memcpy(spec_str + n, spec.width, spec.width_len);
+            n += spec.width_len;
+        }
+        if (spec.has_precision) {
+            spec_str[n++] = '.';
+            if (spec.precision_star) {
+                if (end - args < 1 || *args++ != EH_BINARG_INT || !eh_binlog_read_varint(&args, end, &raw)) return 0;
+                int precision = (int)(int64_t)((raw >> 1) ^ (0 - (raw & 1)));
+                if (precision < 0) {
+                    n--; /* negative means no precision */
+                } else {
+                    n += (size_t)snprintf(spec_str + n, sizeof(spec_str) - n, "%d", precision);
+                }
+            } else if (spec.precision_len < 16) {
+                memcpy(spec_str + n, spec.precision, spec.precision_len);
+                n += spec.precision_len;
+            }
+        }
+        
+        if (end - args < 1) return 0;
+        unsigned char tag = *args++;
+        int written = 0;
+        switch (tag) {
+            case EH_BINARG_INT:
+            case EH_BINARG_UINT: {
+                if (!eh_binlog_read_varint(&args, end, &raw)) return 0;
+                if (spec.conversion == 'c') {
+                    spec_str[n++] = 'c';
+                    spec_str[n] = '\0';
+                    written = snprintf(out + used, size - used, spec_str, (int)(int64_t)((raw >> 1) ^ (0 - (raw & 1))));
+                    break;
+                }
+                spec_str[n++] = 'l';
+                spec_str[n++] = 'l';
+                spec_str[n++] = spec.conversion;
+                spec_str[n] = '\0';
+                if (tag == EH_BINARG_INT) {
+                    written = snprintf(out + used, size - used, spec_str, (long long)((raw >> 1) ^ (0 - (raw & 1))));
+                } else {
+                    written = snprintf(out + used, size - used, spec_str, (unsigned long long)raw);
+                }
+                break;
+            }
+            case EH_BINARG_DOUBLE: {
+                double value;
+                if ((size_t)(end - args) < sizeof(value)) return 0;
+                memcpy(&value, args, sizeof(value));
+                args += sizeof(value);
+                spec_str[n++] = spec.conversion;
+                spec_str[n] = '\0';
+                written = snprintf(out + used, size - used, spec_str, value);
+                break;
+            }
+            case EH_BINARG_STRING: {
+                char str[EH_MAX_ERROR_MSG_SIZE];
+                if (!eh_binlog_read_varint(&args, end, &raw)) return 0;
+                size_t len = (size_t)raw;
+                if (len > (size_t)(end - args)) len = (size_t)(end - args);
+                size_t copy = len < sizeof(str) - 1 ? len : sizeof(str) - 1;
+                memcpy(str, args, copy);
+                str[copy] = '\0';
+                args += len;
+                spec_str[n++] = 's';
+                spec_str[n] = '\0';
+                written = snprintf(out + used, size - used, spec_str, str);
+                break;
+            }
+            case EH_BINARG_POINTER:
+                if (!eh_binlog_read_varint(&args, end, &raw)) return 0;
+                spec_str[n++] = 'p';
+                spec_str[n] = '\0';
+                written = snprintf(out + used, size - used, spec_str, (void*)(uintptr_t)raw);
+                break;
+            default:
+                return 0;
+        }
+        if (written < 0) return 0;
+        used += (size_t)written;
+        if (used >= size) used = size - 1;
+    }
+    return 1;
+}
+
+/* Decodes binary_path into text lines on out; returns EH_SUCCESS or an error code */
+static inline int eh_binlog_decode(const char* binary_path, FILE* out) {
+    FILE* in = fopen(binary_path, "rb");
+    if (!in) return EH_ERROR_FILE_IO;
+    
+    fseek(in, 0, SEEK_END);
+    long file_size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    if (file_size < 24) {
+        fclose(in);
+        return EH_ERROR_CORRUPTED_DATA;
+    }
+    
+    unsigned char* data = (unsigned char*)malloc((size_t)file_size);
+    if (!data) {
+        fclose(in);
+        return EH_ERROR_MEMORY;
+    }
+    size_t size = fread(data, 1, (size_t)file_size, in);
+    fclose(in);
+    
+    if (size < 24 || memcmp(data, EH_BINLOG_MAGIC, 8) != 0) {
+        free(data);
+        return EH_ERROR_CORRUPTED_DATA;
+    }
+    
+    const unsigned char* end = data + size;
+    uint64_t tsc0, last_tsc;
+    int64_t wall0, last_wall;
+    memcpy(&tsc0, data + 8, sizeof(tsc0));
+    memcpy(&wall0, data + 16, sizeof(wall0));
+    last_tsc = tsc0;
+    last_wall = wall0;
+    
+    /* First pass: the last sync point gives the tick rate */
+    for (const unsigned char* p = data + 24; end - p >= 3;) {
+        uint16_t len;
+        memcpy(&len, p + 1, sizeof(len));
+        if ((size_t)(end - p - 3) < len) break;
+        if (p[0] == EH_BINLOG_SYNC && len == 16) {
+            memcpy(&last_tsc, p + 3, sizeof(last_tsc));
+            memcpy(&last_wall, p + 11, sizeof(last_wall));
+        }
+        p += 3 + len;
+    }
+    double ns_per_tick = last_tsc > tsc0 ? (double)(last_wall - wall0) / (double)(last_tsc - tsc0) : 0.0;
+    
+    /* Second pass: rebuild the string table and print records */
+    char** strings = NULL;
+    size_t string_count = 0;
+    int status = EH_SUCCESS;
+    eh_error_context_t context;
+    memset(&context, 0, sizeof(context));
+    
+    for (const unsigned char* p = data + 24; end - p >= 3;) {
+        uint16_t len;
+        memcpy(&len, p + 1, sizeof(len));
+        const unsigned char* body = p + 3;
+        if ((size_t)(end - body) < len) {
+            status = EH_ERROR_CORRUPTED_DATA; /* truncated tail, e.g. after a crash */
+            break;
+        }
+        p = body + len;
+        
+        if (body[-3] == EH_BINLOG_STRING && len >= 4) {
+            uint32_t id;
+            memcpy(&id, body, sizeof(id));
+            if (id >= string_count) {
+                size_t new_count = (id + 1) * 2;
+                char** grown = (char**)realloc(strings, new_count * sizeof(char*));
+                if (!grown) {
+                    status = EH_ERROR_MEMORY;
+                    break;
+                }
+                memset(grown + string_count, 0, (new_count - string_count) * sizeof(char*));
+                strings = grown;
+                string_count = new_count;
+            }
+            free(strings[id]);
+            strings[id] = (char*)malloc(len - 4 + 1);
+            if (strings[id]) {
+                memcpy(strings[id], body + 4, len - 4);
+                strings[id][len - 4] = '\0';
+            }
+        } else if (body[-3] == EH_BINLOG_RECORD && len >= 29) {
+            int32_t code32, line32;
+            uint64_t tsc;
+            uint32_t ids[3];
+            memcpy(&code32, body, sizeof(code32));
+            context.severity = (eh_severity_t)body[4];
+            memcpy(&line32, body + 5, sizeof(line32));
+            memcpy(&tsc, body + 9, sizeof(tsc));
+            memcpy(ids, body + 17, sizeof(ids));
+            
+            const char* names[3];
+            for (int i = 0; i < 3; i++) {
+                names[i] = ids[i] < string_count && strings[ids[i]] ? strings[ids[i]] : "unknown";
+            }
+            
+            context.code = (eh_error_code_t)code32;
+            context.line = line32;
+            context.timestamp = (time_t)((wall0 + (int64_t)((double)(tsc - tsc0) * ns_per_tick)) / 1000000000LL);
+            eh_copy_string(context.function, sizeof(context.function), names[1]);
+            eh_copy_string(context.file, sizeof(context.file), names[2]);
+            if (!eh_binlog_format_message(names[0], body + 29, p, context.message, sizeof(context.message))) {
+                eh_copy_string(context.message, sizeof(context.message), names[0]);
+            }
+            
+            char log_line[2048];
+            eh_format_log_line(&context, log_line, sizeof(log_line));
+            fprintf(out, "%s\n", log_line);
+        }
+    }
+    
+    for (size_t i = 0; i < string_count; i++) free(strings[i]);
+    free(strings);
+    free(data);
+    return status;
+}
+
+/* Windows crash dump generation */
+#ifdef _WIN32
+static void eh_write_crash_dump(EXCEPTION_POINTERS* exception_pointers) {
+    if (!g_eh_config.enable_crash_dumps) return;
+    
+    char dump_filename[512];
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    strftime(dump_filename, sizeof(dump_filename), 
+            "crash_dump_%Y%m%d_%H%M%S.dmp", tm_info);
+    
+    HANDLE dump_file = CreateFileA(dump_filename, GENERIC_WRITE, 0, NULL,
+                                  CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    
+    if (dump_file != INVALID_HANDLE_VALUE) {
+        MINIDUMP_EXCEPTION_INFORMATION dump_info;
+        dump_info.ThreadId = GetCurrentThreadId();
+        dump_info.ExceptionPointers = exception_pointers;
+        dump_info.ClientPointers = FALSE;
+        
+        MiniDumpWriteDump(GetCurrentProcess(), GetCurrentProcessId(),
+                         dump_file, MiniDumpNormal, &dump_info, NULL, NULL);
+        
+        CloseHandle(dump_file);
+        
+        if (g_eh_config.enable_console_output) {
+            fprintf(stderr, "Crash dump written: %s\n", dump_filename);
+        }
+    }
+}
+
+static LONG WINAPI eh_unhandled_exception_filter(EXCEPTION_POINTERS* exception_pointers) {
+    EH_PANIC("Unhandled exception: 0x%08X at address 0x%016llX",
+            exception_pointers->ExceptionRecord->ExceptionCode,
+            (unsigned long long)exception_pointers->ExceptionRecord->ExceptionAddress);
+    
+    eh_write_crash_dump(exception_pointers);
+    
+    return EXCEPTION_EXECUTE_HANDLER;
+}
+
+/* Nothing per thread on Windows; the filter is process-wide */
+static inline void eh_thread_init(void) {
+}
+#else
+/* POSIX crash reports. Everything below runs inside a signal handler, so it
+ * sticks to open/write/close and formats numbers by hand. */
+static const int g_eh_fatal_signals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL };
+#define EH_FATAL_SIGNAL_COUNT (sizeof(g_eh_fatal_signals) / sizeof(g_eh_fatal_signals[0]))
+
+static struct sigaction g_eh_old_actions[EH_FATAL_SIGNAL_COUNT];
+static int g_eh_signals_installed = 0;
+
+/* sigaltstack is per thread; the key frees each thread's stack when it exits */
+static pthread_key_t g_eh_signal_stack_key;
+static int g_eh_signal_stack_key_created = 0;
+static EH_THREAD_LOCAL void* t_eh_signal_stack = NULL;
+
+static void eh_sig_write(int fd, const char* str) {
+    size_t length = strlen(str);
+    while (length > 0) {
+        ssize_t written = write(fd, str, length);
+        if (written <= 0) return;
+        str += written;
+        length -= (size_t)written;
+    }
+}
+
+static void eh_sig_write_uint(int fd, uint64_t value, unsigned base, int min_digits) {
+    char digits[32];
+    int pos = (int)sizeof(digits) - 1;
+    digits[pos] = '\0';
+    do {
+        digits[--pos] = "0123456789abcdef"[value % base];
+        value /= base;
+        min_digits--;
+    } while ((value != 0 || min_digits > 0) && pos > 0);
+    eh_sig_write(fd, &digits[pos]);
+}
+
+static const char* eh_signal_name(int sig) {
+    switch (sig) {
+        case SIGSEGV: return "SIGSEGV";
+        case SIGBUS:  return "SIGBUS";
+        case SIGFPE:  return "SIGFPE";
+        case SIGILL:  return "SIGILL";
+        default:      return "signal";
+    }
+}
+
+/* crash_dump_YYYYmmdd_HHMMSS.txt in UTC; localtime() is not signal-safe */
+static void eh_crash_filename(char* out, size_t size) {
+    int64_t now = (int64_t)time(NULL);
+    int64_t days = now / 86400;
+    int64_t secs = now % 86400;
+    
+    /* Civil date from days since 1970-01-01 */
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t doe = days - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int64_t day = doy - (153 * mp + 2) / 5 + 1;
+    int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t year = yoe + era * 400 + (month <= 2);
+    
+    int64_t fields[6] = { year, month, day, secs / 3600, (secs / 60) % 60, secs % 60 };
+    int widths[6] = { 4, 2, 2, 2, 2, 2 };
+    const char* prefix = "crash_dump_";
+    size_t pos = 0;
+    while (*prefix && pos + 1 < size) out[pos++] = *prefix++;
+    for (int i = 0; i < 6; i++) {
+        if (i == 3 && pos + 1 < size) out[pos++] = '_';
+        int64_t value = fields[i];
+        for (int w = widths[i] - 1; w >= 0; w--) {
+            int64_t scale = 1;
+            for (int k = 0; k < w; k++) scale *= 10;
+            if (pos + 1 < size) out[pos++] = (char)('0' + (value / scale) % 10);
+        }
+    }
+    const char* suffix = ".txt";
+    while (*suffix && pos + 1 < size) out[pos++] = *suffix++;
+    out[pos] = '\0';
+}
+
+static void eh_write_crash_report(int sig, siginfo_t* info) {
+    char dump_filename[64];
+    eh_crash_filename(dump_filename, sizeof(dump_filename));
+    
+    int fd = open(dump_filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+    
+    eh_sig_write(fd, "=== Crash Report ===\nSignal: ");
+    eh_sig_write(fd, eh_signal_name(sig));
+    eh_sig_write(fd, " (");
+    eh_sig_write_uint(fd, (uint64_t)sig, 10, 1);
+    eh_sig_write(fd, "), code ");
+    eh_sig_write_uint(fd, (uint64_t)(uint32_t)info->si_code, 10, 1);
+    eh_sig_write(fd, "\nFault address: 0x");
+    eh_sig_write_uint(fd, (uint64_t)(uintptr_t)info->si_addr, 16, 16);
+    eh_sig_write(fd, "\nProcess: ");
+    eh_sig_write_uint(fd, (uint64_t)getpid(), 10, 1);
+    eh_sig_write(fd, "\n");
+    
+    /* Last error this thread reported, if any */
+    if (t_eh_last_error.message[0] != '\0') {
+        eh_sig_write(fd, "Last error: ");
+        eh_sig_write(fd, t_eh_last_error.message);
+        eh_sig_write(fd, " in ");
+        eh_sig_write(fd, t_eh_last_error.function);
+        eh_sig_write(fd, "() at ");
+        eh_sig_write(fd, t_eh_last_error.file);
+        eh_sig_write(fd, ":");
+        eh_sig_write_uint(fd, (uint64_t)(uint32_t)t_eh_last_error.line, 10, 1);
+        eh_sig_write(fd, "\n");
+    }
+    
+#ifdef EH_HAVE_EXECINFO
+    /* Unwinder was loaded in eh_init, so this does not allocate */
+    void* frames[EH_MAX_STACK_FRAMES];
+    int depth = backtrace(frames, EH_MAX_STACK_FRAMES);
+    eh_sig_write(fd, "\nStack trace:\n");
+    backtrace_symbols_fd(frames, depth, fd);
+#endif
+    
+#ifdef __linux__
+    /* Module layout, so addresses can be symbolized offline */
+    int maps = open("/proc/self/maps", O_RDONLY);
+    if (maps >= 0) {
+        char buffer[4096];
+        ssize_t n;
+        eh_sig_write(fd, "\nMemory map:\n");
+        while ((n = read(maps, buffer, sizeof(buffer) - 1)) > 0) {
+            buffer[n] = '\0';
+            eh_sig_write(fd, buffer);
+        }
+        close(maps);
+    }
+#endif
+    
+    close(fd);
+    
+    if (g_eh_config.enable_console_output) {
+        eh_sig_write(STDERR_FILENO, "Fatal ");
+        eh_sig_write(STDERR_FILENO, eh_signal_name(sig));
+        eh_sig_write(STDERR_FILENO, ", crash report written: ");
+        eh_sig_write(STDERR_FILENO, dump_filename);
+        eh_sig_write(STDERR_FILENO, "\n");
+    }
+}
+
+static void eh_fatal_signal_handler(int sig, siginfo_t* info, void* ucontext) {
+    (void)ucontext;
+    int saved_errno = errno;
+    eh_write_crash_report(sig, info);
+    errno = saved_errno;
+    
+    /* SA_RESETHAND put the default action back; re-raise for the core file */
+    raise(sig);
+}
+
+/* Disables the calling thread's alternate stack before freeing it */
+static void eh_signal_stack_release(void* stack) {
+    stack_t alt_stack;
+    memset(&alt_stack, 0, sizeof(alt_stack));
+    alt_stack.ss_flags = SS_DISABLE;
+    sigaltstack(&alt_stack, NULL);
+    free(stack);
+}
+
+/* Gives the calling thread an alternate stack for the crash handler: stack
+ * overflows land in SIGSEGV with no stack left to run on. Runs from every
+ * enabled log call, at any severity, and only allocates on the first; call it
+ * at thread start for threads that may crash before logging anything */
+static inline void eh_thread_init(void) {
+    if (!g_eh_signals_installed || t_eh_signal_stack) return;
+    
+    /* Leave a stack the application installed itself alone */
+    stack_t alt_stack;
+    if (sigaltstack(NULL, &alt_stack) == 0 && !(alt_stack.ss_flags & SS_DISABLE)) return;
+    
+    void* stack = malloc(EH_SIGNAL_STACK_SIZE);
+    if (!stack) return;
+    alt_stack.ss_sp = stack;
+    alt_stack.ss_size = EH_SIGNAL_STACK_SIZE;
+    alt_stack.ss_flags = 0;
+    if (sigaltstack(&alt_stack, NULL) != 0) {
+        free(stack);
+        return;
+    }
+    t_eh_signal_stack = stack;
+    pthread_setspecific(g_eh_signal_stack_key, stack);
+}
+
+static void eh_install_signal_handlers(void) {
+    if (g_eh_signals_installed) return;
+    
+    /* Never deleted: threads still holding a stack free it through the key */
+    if (!g_eh_signal_stack_key_created) {
+        if (pthread_key_create(&g_eh_signal_stack_key, eh_signal_stack_release) != 0) return;
+        g_eh_signal_stack_key_created = 1;
+    }
+    
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = eh_fatal_signal_handler;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESETHAND;
+    sigemptyset(&action.sa_mask);
+    
+    for (size_t i = 0; i < EH_FATAL_SIGNAL_COUNT; i++) {
+        sigaction(g_eh_fatal_signals[i], &action, &g_eh_old_actions[i]);
+    }
+    g_eh_signals_installed = 1;
+    eh_thread_init();
+}
+
+static void eh_restore_signal_handlers(void) {
+    if (!g_eh_signals_installed) return;
+    
+    for (size_t i = 0; i < EH_FATAL_SIGNAL_COUNT; i++) {
+        sigaction(g_eh_fatal_signals[i], &g_eh_old_actions[i], NULL);
+    }
+    
+    /* Other threads keep theirs until they exit */
+    if (t_eh_signal_stack) {
+        pthread_setspecific(g_eh_signal_stack_key, NULL);
+        eh_signal_stack_release(t_eh_signal_stack);
+        t_eh_signal_stack = NULL;
+    }
+    g_eh_signals_installed = 0;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* ERROR_HANDLER_H */
\ No newline at end of file
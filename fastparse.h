@@ -1,606 +1,4545 @@
-/*
- * FastParse - Fast header parsing library in C for C
- * Features:
- * - Zero-copy string views with automatic lifetime management
- * - SIMD-accelerated whitespace skipping and delimiter finding
- * - Compile-time string literal optimization
- * - Stack-allocated parser contexts (no malloc)
- * - Chainable parser operations
- * - Built-in number parsing with overflow detection
- * - CSV, JSON, and custom delimiter parsing
- * - Error recovery with detailed diagnostics
- */
-
-#ifndef FASTPARSE_H
-#define FASTPARSE_H
-
-#include <stdint.h>
-#include <stdbool.h>
-#include <string.h>
-#include <stdlib.h>
-#include <ctype.h>
-#include <limits.h>
-
-#ifdef __SSE2__
-#include <emmintrin.h>
-#define FASTPARSE_SIMD_ENABLED 1
-#endif
-#include <stdio.h>
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-// ============================================================================
-// CORE TYPES
-// ============================================================================
-
-typedef struct {
-    const char* data;
-    size_t len;
-} fp_view_t;
-
-typedef struct {
-    const char* start;
-    const char* current;
-    const char* end;
-    size_t line;
-    size_t column;
-    int error_code;
-    char error_msg[256];
-} fp_parser_t;
-
-typedef enum {
-    FP_OK = 0,
-    FP_ERROR_EOF,
-    FP_ERROR_INVALID_NUMBER,
-    FP_ERROR_OVERFLOW,
-    FP_ERROR_INVALID_ESCAPE,
-    FP_ERROR_UNTERMINATED_STRING,
-    FP_ERROR_CUSTOM
-} fp_error_t;
-
-// ============================================================================
-// SIMD-ACCELERATED UTILITIES
-// ============================================================================
-
-#ifdef FASTPARSE_SIMD_ENABLED
-static inline const char* fp_skip_whitespace_simd(const char* str, const char* end) {
-    const char* p = str;
-    
-    // SIMD loop for 16-byte chunks
-    while (p + 16 <= end) {
-        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
-        __m128i spaces = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '));
-        __m128i tabs = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'));
-        __m128i newlines = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'));
-        __m128i returns = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'));
-        
-        __m128i whitespace = _mm_or_si128(_mm_or_si128(spaces, tabs), 
-                                        _mm_or_si128(newlines, returns));
-        
-        int mask = _mm_movemask_epi8(whitespace);
-        if (mask != 0xFFFF) {
-            // Found non-whitespace, scan byte by byte from here
-            break;
-        }
-        p += 16;
-    }
-    
-    // Finish with scalar loop
-    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
-        p++;
-    }
-    
-    return p;
-}
-#endif
-
-static inline const char* fp_skip_whitespace(const char* str, const char* end) {
-#ifdef FASTPARSE_SIMD_ENABLED
-    return fp_skip_whitespace_simd(str, end);
-#else
-    while (str < end && (*str == ' ' || *str == '\t' || *str == '\n' || *str == '\r')) {
-        str++;
-    }
-    return str;
-#endif
-}
-
-// ============================================================================
-// STRING VIEW OPERATIONS
-// ============================================================================
-
-#define FP_VIEW(literal) ((fp_view_t){.data = literal, .len = sizeof(literal) - 1})
-#define FP_VIEW_FROM_CSTR(str) ((fp_view_t){.data = str, .len = strlen(str)})
-#define FP_VIEW_EMPTY() ((fp_view_t){.data = NULL, .len = 0})
-
-static inline fp_view_t fp_view_substr(fp_view_t view, size_t start, size_t len) {
-    if (start >= view.len) return FP_VIEW_EMPTY();
-    if (start + len > view.len) len = view.len - start;
-    return (fp_view_t){.data = view.data + start, .len = len};
-}
-
-static inline bool fp_view_equals(fp_view_t a, fp_view_t b) {
-    return a.len == b.len && memcmp(a.data, b.data, a.len) == 0;
-}
-
-static inline bool fp_view_starts_with(fp_view_t view, fp_view_t prefix) {
-    return view.len >= prefix.len && memcmp(view.data, prefix.data, prefix.len) == 0;
-}
-
-static inline int fp_view_compare(fp_view_t a, fp_view_t b) {
-    size_t min_len = a.len < b.len ? a.len : b.len;
-    int result = memcmp(a.data, b.data, min_len);
-    if (result == 0) {
-        return a.len < b.len ? -1 : (a.len > b.len ? 1 : 0);
-    }
-    return result;
-}
-
-// Convert view to null-terminated string (WARNING: allocates memory)
-static inline char* fp_view_to_cstr(fp_view_t view) {
-    char* result = (char*)malloc(view.len + 1);
-    if (result) {
-        memcpy(result, view.data, view.len);
-        result[view.len] = '\0';
-    }
-    return result;
-}
-
-// ============================================================================
-// PARSER INITIALIZATION AND STATE
-// ============================================================================
-
-static inline fp_parser_t fp_init(const char* input, size_t len) {
-    return (fp_parser_t){
-        .start = input,
-        .current = input,
-        .end = input + len,
-        .line = 1,
-        .column = 1,
-        .error_code = FP_OK,
-        .error_msg = {0}
-    };
-}
-
-static inline fp_parser_t fp_init_cstr(const char* input) {
-    return fp_init(input, strlen(input));
-}
-
-static inline bool fp_at_end(const fp_parser_t* p) {
-    return p->current >= p->end;
-}
-
-static inline size_t fp_remaining(const fp_parser_t* p) {
-    return p->end - p->current;
-}
-
-static inline char fp_peek(const fp_parser_t* p) {
-    return fp_at_end(p) ? '\0' : *p->current;
-}
-
-static inline char fp_advance(fp_parser_t* p) {
-    if (fp_at_end(p)) return '\0';
-    
-    char c = *p->current++;
-    if (c == '\n') {
-        p->line++;
-        p->column = 1;
-    } else {
-        p->column++;
-    }
-    return c;
-}
-
-// ============================================================================
-// ERROR HANDLING
-// ============================================================================
-
-static inline void fp_set_error(fp_parser_t* p, fp_error_t code, const char* msg) {
-    p->error_code = code;
-    strncpy(p->error_msg, msg, sizeof(p->error_msg) - 1);
-    p->error_msg[sizeof(p->error_msg) - 1] = '\0';
-}
-
-static inline bool fp_has_error(const fp_parser_t* p) {
-    return p->error_code != FP_OK;
-}
-
-// ============================================================================
-// WHITESPACE AND DELIMITER HANDLING
-// ============================================================================
-
-static inline void fp_skip_ws(fp_parser_t* p) {
-    const char* new_pos = fp_skip_whitespace(p->current, p->end);
-    
-    // Update line/column tracking
-    while (p->current < new_pos) {
-        if (*p->current == '\n') {
-            p->line++;
-            p->column = 1;
-        } else {
-            p->column++;
-        }
-        p->current++;
-    }
-}
-
-static inline bool fp_match_char(fp_parser_t* p, char expected) {
-    if (fp_peek(p) == expected) {
-        fp_advance(p);
-        return true;
-    }
-    return false;
-}
-
-static inline bool fp_match_str(fp_parser_t* p, fp_view_t expected) {
-    if (fp_remaining(p) >= expected.len && 
-        memcmp(p->current, expected.data, expected.len) == 0) {
-        p->current += expected.len;
-        p->column += expected.len;
-        return true;
-    }
-    return false;
-}
-
-// ============================================================================
-// ULTRA-FAST NUMBER PARSING
-// ============================================================================
-
-static inline bool fp_parse_int64(fp_parser_t* p, int64_t* result) {
-    fp_skip_ws(p);
-    
-    if (fp_at_end(p)) {
-        fp_set_error(p, FP_ERROR_EOF, "Expected number");
-        return false;
-    }
-    
-    bool negative = false;
-    if (fp_peek(p) == '-') {
-        negative = true;
-        fp_advance(p);
-    } else if (fp_peek(p) == '+') {
-        fp_advance(p);
-    }
-    
-    if (!isdigit(fp_peek(p))) {
-        fp_set_error(p, FP_ERROR_INVALID_NUMBER, "Expected digit");
-        return false;
-    }
-    
-    uint64_t value = 0;
-    const uint64_t max_val = negative ? (uint64_t)INT64_MAX + 1 : INT64_MAX;
-    
-    while (!fp_at_end(p) && isdigit(fp_peek(p))) {
-        uint64_t digit = fp_peek(p) - '0';
-        
-        // Check for overflow
-        if (value > (max_val - digit) / 10) {
-            fp_set_error(p, FP_ERROR_OVERFLOW, "Integer overflow");
-            return false;
-        }
-        
-        value = value * 10 + digit;
-        fp_advance(p);
-    }
-    
-    *result = negative ? -(int64_t)value : (int64_t)value;
-    return true;
-}
-
-static inline bool fp_parse_double(fp_parser_t* p, double* result) {
-    fp_skip_ws(p);
-    
-    const char* start = p->current;
-    char* end_ptr;
-    
-    *result = strtod(start, &end_ptr);
-    
-    if (end_ptr == start) {
-        fp_set_error(p, FP_ERROR_INVALID_NUMBER, "Expected number");
-        return false;
-    }
-    
-    // Update parser position
-    size_t consumed = end_ptr - start;
-    p->current += consumed;
-    p->column += consumed;
-    
-    return true;
-}
-
-// ============================================================================
-// STRING PARSING WITH ESCAPE SEQUENCES
-// ============================================================================
-
-static inline bool fp_parse_quoted_string(fp_parser_t* p, fp_view_t* result) {
-    fp_skip_ws(p);
-    
-    if (!fp_match_char(p, '"')) {
-        fp_set_error(p, FP_ERROR_UNTERMINATED_STRING, "Expected opening quote");
-        return false;
-    }
-    
-    const char* start = p->current;
-    
-    while (!fp_at_end(p) && fp_peek(p) != '"') {
-        if (fp_peek(p) == '\\') {
-            fp_advance(p); // Skip backslash
-            if (fp_at_end(p)) break;
-            fp_advance(p); // Skip escaped character
-        } else {
-            fp_advance(p);
-        }
-    }
-    
-    if (!fp_match_char(p, '"')) {
-        fp_set_error(p, FP_ERROR_UNTERMINATED_STRING, "Expected closing quote");
-        return false;
-    }
-    
-    *result = (fp_view_t){.data = start, .len = p->current - start - 1};
-    return true;
-}
-
-// ============================================================================
-// CSV PARSING
-// ============================================================================
-
-typedef struct {
-    fp_view_t* fields;
-    size_t count;
-    size_t capacity;
-} fp_csv_row_t;
-
-static inline bool fp_parse_csv_field(fp_parser_t* p, fp_view_t* field) {
-    fp_skip_ws(p);
-    
-    if (fp_at_end(p)) return false;
-    
-    if (fp_peek(p) == '"') {
-        return fp_parse_quoted_string(p, field);
-    } else {
-        const char* start = p->current;
-        while (!fp_at_end(p) && fp_peek(p) != ',' && fp_peek(p) != '\n' && fp_peek(p) != '\r') {
-            fp_advance(p);
-        }
-        
-        // Trim trailing whitespace
-        const char* end = p->current;
-        while (end > start && (end[-1] == ' ' || end[-1] == '\t')) {
-            end--;
-        }
-        
-        *field = (fp_view_t){.data = start, .len = end - start};
-        return true;
-    }
-}
-
-// Stack-allocated CSV parsing (no malloc)
-#define FP_CSV_MAX_FIELDS 64
-
-static inline size_t fp_parse_csv_line(fp_parser_t* p, fp_view_t fields[FP_CSV_MAX_FIELDS]) {
-    size_t count = 0;
-    
-    while (!fp_at_end(p) && count < FP_CSV_MAX_FIELDS) {
-        if (!fp_parse_csv_field(p, &fields[count])) {
-            break;
-        }
-        count++;
-        
-        if (!fp_match_char(p, ',')) {
-            break;
-        }
-    }
-    
-    // Skip line ending
-    if (fp_match_char(p, '\r')) {
-        fp_match_char(p, '\n');
-    } else {
-        fp_match_char(p, '\n');
-    }
-    
-    return count;
-}
-
-// ============================================================================
-// JSON-LIKE PARSING
-// ============================================================================
-
-static inline bool fp_parse_json_string(fp_parser_t* p, fp_view_t* result) {
-    return fp_parse_quoted_string(p, result);
-}
-
-static inline bool fp_parse_json_number(fp_parser_t* p, double* result) {
-    return fp_parse_double(p, result);
-}
-
-static inline bool fp_skip_json_value(fp_parser_t* p);
-
-static inline bool fp_skip_json_object(fp_parser_t* p) {
-    if (!fp_match_char(p, '{')) return false;
-    
-    fp_skip_ws(p);
-    if (fp_match_char(p, '}')) return true; // Empty object
-    
-    do {
-        fp_skip_ws(p);
-        
-        // Skip key
-        fp_view_t key;
-        if (!fp_parse_json_string(p, &key)) return false;
-        
-        fp_skip_ws(p);
-        if (!fp_match_char(p, ':')) return false;
-        
-        fp_skip_ws(p);
-        if (!fp_skip_json_value(p)) return false;
-        
-        fp_skip_ws(p);
-    } while (fp_match_char(p, ','));
-    
-    return fp_match_char(p, '}');
-}
-
-static inline bool fp_skip_json_array(fp_parser_t* p) {
-    if (!fp_match_char(p, '[')) return false;
-    
-    fp_skip_ws(p);
-    if (fp_match_char(p, ']')) return true; // Empty array
-    
-    do {
-        fp_skip_ws(p);
-        if (!fp_skip_json_value(p)) return false;
-        fp_skip_ws(p);
-    } while (fp_match_char(p, ','));
-    
-    return fp_match_char(p, ']');
-}
-
-static inline bool fp_skip_json_value(fp_parser_t* p) {
-    fp_skip_ws(p);
-    
-    char c = fp_peek(p);
-    switch (c) {
-        case '"': {
-            fp_view_t str;
-            return fp_parse_json_string(p, &str);
-        }
-        case '{':
-            return fp_skip_json_object(p);
-        case '[':
-            return fp_skip_json_array(p);
-        case 't':
-            return fp_match_str(p, FP_VIEW("true"));
-        case 'f':
-            return fp_match_str(p, FP_VIEW("false"));
-        case 'n':
-            return fp_match_str(p, FP_VIEW("null"));
-        default:
-            if (c == '-' || isdigit(c)) {
-                double num;
-                return fp_parse_json_number(p, &num);
-            }
-            return false;
-    }
-}
-
-// ============================================================================
-// CHAINABLE PARSER COMBINATORS
-// ============================================================================
-
-typedef struct fp_chain fp_chain_t;
-struct fp_chain {
-    fp_parser_t* parser;
-    bool success;
-    fp_view_t result;
-};
-
-static inline fp_chain_t fp_chain(fp_parser_t* p) {
-    return (fp_chain_t){.parser = p, .success = true, .result = FP_VIEW_EMPTY()};
-}
-
-static inline fp_chain_t fp_then_skip_ws(fp_chain_t chain) {
-    if (chain.success) {
-        fp_skip_ws(chain.parser);
-    }
-    return chain;
-}
-
-static inline fp_chain_t fp_then_expect_char(fp_chain_t chain, char expected) {
-    if (chain.success) {
-        chain.success = fp_match_char(chain.parser, expected);
-        if (!chain.success) {
-            char msg[64];
-            snprintf(msg, sizeof(msg), "Expected '%c'", expected);
-            fp_set_error(chain.parser, FP_ERROR_CUSTOM, msg);
-        }
-    }
-    return chain;
-}
-
-static inline fp_chain_t fp_then_parse_string(fp_chain_t chain) {
-    if (chain.success) {
-        chain.success = fp_parse_quoted_string(chain.parser, &chain.result);
-    }
-    return chain;
-}
-
-// ============================================================================
-// UTILITY MACROS
-// ============================================================================
-
-#define FP_PARSE_OR_RETURN(parser, func, ...) \
-    do { \
-        if (!func(parser, __VA_ARGS__)) { \
-            return false; \
-        } \
-    } while(0)
-
-#define FP_EXPECT_CHAR_OR_RETURN(parser, ch) \
-    do { \
-        if (!fp_match_char(parser, ch)) { \
-            char msg[64]; \
-            snprintf(msg, sizeof(msg), "Expected '%c' at line %zu, column %zu", ch, parser->line, parser->column); \
-            fp_set_error(parser, FP_ERROR_CUSTOM, msg); \
-            return false; \
-        } \
-    } while(0)
-
-#define FP_CHAIN_BEGIN(parser) fp_chain(parser)
-#define FP_CHAIN_OK(chain) ((chain).success)
-#define FP_CHAIN_RESULT(chain) ((chain).result)
-
-// ============================================================================
-// PERFORMANCE BENCHMARKING
-// ============================================================================
-
-#ifdef FP_ENABLE_BENCHMARKS
-#include <time.h>
-
-static inline double fp_get_time_ms(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
-}
-
-#define FP_BENCHMARK(name, code) \
-    do { \
-        double start = fp_get_time_ms(); \
-        code; \
-        double end = fp_get_time_ms(); \
-        printf("Benchmark %s: %.3f ms\n", name, end - start); \
-    } while(0)
-#endif
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif // FASTPARSE_H
-
-/*
- * USAGE EXAMPLES:
- * 
- * // Basic parsing
- * fp_parser_t p = fp_init_cstr("42, hello, 3.14");
- * int64_t num;
- * fp_parse_int64(&p, &num); // num = 42
- * 
- * // CSV parsing
- * fp_view_t fields[FP_CSV_MAX_FIELDS];
- * size_t count = fp_parse_csv_line(&p, fields);
- * 
- * // Chainable operations
- * auto chain = FP_CHAIN_BEGIN(&p)
- *     .then_skip_ws()
- *     .then_expect_char('{')
- *     .then_parse_string();
- * 
- * // String views (zero-copy)
- * fp_view_t view = FP_VIEW("hello");
- * if (fp_view_equals(view, FP_VIEW("hello"))) {
- *     // matches!
- * }
+/*
+ * FastParse - Fast header parsing library in C for C
+ * Features:
+ * - Zero-copy string views with automatic lifetime management
+ * - SIMD-accelerated whitespace skipping and delimiter finding
+ * - Compile-time string literal optimization
+ * - Stack-allocated parser contexts (no malloc)
+ * - Chainable parser operations
+ * - Built-in number parsing with overflow detection
+ * - CSV, JSON, and custom delimiter parsing
+ * - Error recovery with detailed diagnostics
+ */
+
+#ifndef FASTPARSE_H
+#define FASTPARSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <limits.h>
+#include <locale.h>
+
+// x86-64 always has SSE2; AVX2 and AVX-512 kernels are compiled with target
+// attributes and picked at runtime. NEON is part of the aarch64 baseline.
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#define FASTPARSE_SIMD_ENABLED 1
+#define FP_SIMD_X86 1
+#if defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+#define FP_SIMD_HAVE_AVX512 1
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FASTPARSE_SIMD_ENABLED 1
+#define FP_SIMD_NEON 1
+#endif
+#include <stdio.h>
+
+// File input (fp_open_mapped); define FP_NO_FILE_IO to leave it out
+#ifndef FP_NO_FILE_IO
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <errno.h>
+#endif
+
+// Worker threads (fp_parallel_for); define FP_NO_THREADS to leave them out
+#ifndef FP_NO_THREADS
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+#endif
+
+// SWAR number parsing reads 8 input bytes as one little-endian word
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || \
+    defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+#define FP_LITTLE_ENDIAN 1
+#endif
+
+// Functions the C++ build can also evaluate at compile time (fp::make_keyset)
+#if defined(__cplusplus) && (__cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L))
+#define FP_CONSTEXPR constexpr
+#else
+#define FP_CONSTEXPR
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// CORE TYPES
+// ============================================================================
+
+typedef struct {
+    const char* data;
+    size_t len;
+} fp_view_t;
+
+// Define FP_LAZY_POSITION to stop tracking line/column on every byte. They
+// are then computed from the buffer only when asked for (fp_get_position) or
+// when an error is set.
+//
+// Define FP_COMPACT_ERRORS to drop the 256-byte message buffer: an error then
+// records its code, offset, a static message and one int argument, and text
+// is only produced by fp_format_error. The parser shrinks to 72 bytes and a
+// failed match costs a few stores.
+typedef struct {
+    const char* start;
+    const char* current;
+    const char* end;
+    size_t line;
+    size_t column;
+    const char* position_mark;  // FP_LAZY_POSITION: where line/column were last computed
+    int error_code;
+#ifdef FP_COMPACT_ERRORS
+    int error_arg;              // argument for error_msg's %c/%d, if it has one
+    const char* error_msg;      // static text, never copied
+#else
+    char error_msg[256];
+#endif
+    size_t error_offset;        // where the error was set, from start
+} fp_parser_t;
+
+typedef enum {
+    FP_OK = 0,
+    FP_ERROR_EOF,
+    FP_ERROR_INVALID_NUMBER,
+    FP_ERROR_OVERFLOW,
+    FP_ERROR_INVALID_ESCAPE,
+    FP_ERROR_UNTERMINATED_STRING,
+    FP_ERROR_CUSTOM,
+    FP_ERROR_IO,
+    FP_ERROR_CAPACITY
+} fp_error_t;
+
+// ============================================================================
+// SIMD-ACCELERATED UTILITIES
+// ============================================================================
+
+// Each scanner returns the first position in [p, end) that stops the scan,
+// or end. Kernels never read past end.
+typedef const char* (*fp_scan_fn_t)(const char* p, const char* end);
+
+typedef enum {
+    FP_SIMD_SCALAR = 0,
+    FP_SIMD_SSE2,
+    FP_SIMD_NEON,
+    FP_SIMD_AVX2,
+    FP_SIMD_AVX512
+} fp_simd_level_t;
+
+static inline bool fp_is_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline const char* fp_skip_whitespace_scalar(const char* p, const char* end) {
+    while (p < end && fp_is_whitespace(*p)) p++;
+    return p;
+}
+
+static inline const char* fp_find_csv_delimiter_scalar(const char* p, const char* end) {
+    while (p < end && *p != ',' && *p != '\n' && *p != '\r') p++;
+    return p;
+}
+
+static inline const char* fp_find_quote_scalar(const char* p, const char* end) {
+    while (p < end && *p != '"' && *p != '\\') p++;
+    return p;
+}
+
+// Newline counter, used to work out line numbers on demand
+typedef size_t (*fp_count_fn_t)(const char* p, const char* end);
+
+static inline size_t fp_count_newlines_scalar(const char* p, const char* end) {
+    size_t count = 0;
+    for (; p < end; p++) count += (*p == '\n');
+    return count;
+}
+
+// JSON stage-1 classifier: for a 64-byte block, bit i of masks[0] is set when
+// byte i is '"', masks[1] for '\\', masks[2] for one of {}[]:,
+typedef void (*fp_json_classify_fn_t)(const char* block, uint64_t masks[3]);
+
+static inline void fp_json_classify_scalar(const char* block, uint64_t masks[3]) {
+    uint64_t quotes = 0, backslashes = 0, ops = 0;
+    for (int i = 0; i < 64; i++) {
+        char c = block[i];
+        uint64_t bit = 1ULL << i;
+        if (c == '"') quotes |= bit;
+        else if (c == '\\') backslashes |= bit;
+        else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') ops |= bit;
+    }
+    masks[0] = quotes;
+    masks[1] = backslashes;
+    masks[2] = ops;
+}
+
+static inline unsigned fp_ctz32(uint32_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(x);
+#endif
+}
+
+static inline unsigned fp_popcount64(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (unsigned)__popcnt64(x);
+#else
+    return (unsigned)__builtin_popcountll(x);
+#endif
+}
+
+static inline unsigned fp_ctz64(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctzll(x);
+#endif
+}
+
+#ifdef FP_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#define FP_TARGET_AVX2
+#define FP_TARGET_AVX512
+#else
+#define FP_TARGET_AVX2 __attribute__((target("avx2")))
+#define FP_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+// SSE2: 16 bytes per step, movemask bit set for every byte that stops the scan
+static inline uint32_t fp_sse2_ws_stop(__m128i chunk) {
+    __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                                           _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                              _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')),
+                                           _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+    return (uint32_t)_mm_movemask_epi8(ws) ^ 0xFFFFu;
+}
+
+static inline uint32_t fp_sse2_delim_stop(__m128i chunk) {
+    __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')),
+                               _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')),
+                                            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+    return (uint32_t)_mm_movemask_epi8(hit);
+}
+
+static inline uint32_t fp_sse2_quote_stop(__m128i chunk) {
+    __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+                               _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+    return (uint32_t)_mm_movemask_epi8(hit);
+}
+
+static inline const char* fp_skip_whitespace_sse2(const char* p, const char* end) {
+    for (; p + 16 <= end; p += 16) {
+        uint32_t stop = fp_sse2_ws_stop(_mm_loadu_si128((const __m128i*)p));
+        if (stop) return p + fp_ctz32(stop);
+    }
+    return fp_skip_whitespace_scalar(p, end);
+}
+
+static inline const char* fp_find_csv_delimiter_sse2(const char* p, const char* end) {
+    for (; p + 16 <= end; p += 16) {
+        uint32_t stop = fp_sse2_delim_stop(_mm_loadu_si128((const __m128i*)p));
+        if (stop) return p + fp_ctz32(stop);
+    }
+    return fp_find_csv_delimiter_scalar(p, end);
+}
+
+static inline const char* fp_find_quote_sse2(const char* p, const char* end) {
+    for (; p + 16 <= end; p += 16) {
+        uint32_t stop = fp_sse2_quote_stop(_mm_loadu_si128((const __m128i*)p));
+        if (stop) return p + fp_ctz32(stop);
+    }
+    return fp_find_quote_scalar(p, end);
+}
+
+static inline size_t fp_count_newlines_sse2(const char* p, const char* end) {
+    size_t count = 0;
+    for (; p + 16 <= end; p += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        count += fp_popcount64((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+    }
+    return count + fp_count_newlines_scalar(p, end);
+}
+
+static inline uint32_t fp_sse2_ops_mask(__m128i chunk) {
+    __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')),
+                                            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}'))),
+                               _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')),
+                                            _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']'))));
+    hit = _mm_or_si128(hit, _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')),
+                                         _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','))));
+    return (uint32_t)_mm_movemask_epi8(hit);
+}
+
+static void fp_json_classify_sse2(const char* block, uint64_t masks[3]) {
+    masks[0] = masks[1] = masks[2] = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+        masks[0] |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))) << (16 * i);
+        masks[1] |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))) << (16 * i);
+        masks[2] |= (uint64_t)fp_sse2_ops_mask(chunk) << (16 * i);
+    }
+}
+
+// AVX2: 32 bytes per step, the sub-32 tail goes through the SSE2 kernel
+FP_TARGET_AVX2 static inline uint32_t fp_avx2_ws_stop(__m256i chunk) {
+    __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                                                 _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+                                 _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')),
+                                                 _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+    return ~(uint32_t)_mm256_movemask_epi8(ws);
+}
+
+FP_TARGET_AVX2 static inline uint32_t fp_avx2_delim_stop(__m256i chunk) {
+    __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')),
+                                  _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')),
+                                                  _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+    return (uint32_t)_mm256_movemask_epi8(hit);
+}
+
+FP_TARGET_AVX2 static inline uint32_t fp_avx2_quote_stop(__m256i chunk) {
+    __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')),
+                                  _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+    return (uint32_t)_mm256_movemask_epi8(hit);
+}
+
+FP_TARGET_AVX2 static const char* fp_skip_whitespace_avx2(const char* p, const char* end) {
+    for (; p + 32 <= end; p += 32) {
+        uint32_t stop = fp_avx2_ws_stop(_mm256_loadu_si256((const __m256i*)p));
+        if (stop) return p + fp_ctz32(stop);
+    }
+    return fp_skip_whitespace_sse2(p, end);
+}
+
+FP_TARGET_AVX2 static const char* fp_find_csv_delimiter_avx2(const char* p, const char* end) {
+    for (; p + 32 <= end; p += 32) {
+        uint32_t stop = fp_avx2_delim_stop(_mm256_loadu_si256((const __m256i*)p));
+        if (stop) return p + fp_ctz32(stop);
+    }
+    return fp_find_csv_delimiter_sse2(p, end);
+}
+
+FP_TARGET_AVX2 static const char* fp_find_quote_avx2(const char* p, const char* end) {
+    for (; p + 32 <= end; p += 32) {
+        uint32_t stop = fp_avx2_quote_stop(_mm256_loadu_si256((const __m256i*)p));
+        if (stop) return p + fp_ctz32(stop);
+    }
+    return fp_find_quote_sse2(p, end);
+}
+
+FP_TARGET_AVX2 static size_t fp_count_newlines_avx2(const char* p, const char* end) {
+    size_t count = 0;
+    for (; p + 32 <= end; p += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+        count += fp_popcount64((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))));
+    }
+    return count + fp_count_newlines_sse2(p, end);
+}
+
+FP_TARGET_AVX2 static inline uint32_t fp_avx2_ops_mask(__m256i chunk) {
+    __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('{')),
+                                                  _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('}'))),
+                                  _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('[')),
+                                                  _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(']'))));
+    hit = _mm256_or_si256(hit, _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')),
+                                               _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','))));
+    return (uint32_t)_mm256_movemask_epi8(hit);
+}
+
+FP_TARGET_AVX2 static void fp_json_classify_avx2(const char* block, uint64_t masks[3]) {
+    __m256i lo = _mm256_loadu_si256((const __m256i*)block);
+    __m256i hi = _mm256_loadu_si256((const __m256i*)(block + 32));
+    __m256i quote = _mm256_set1_epi8('"');
+    __m256i backslash = _mm256_set1_epi8('\\');
+    masks[0] = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, quote)) |
+               ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, quote)) << 32);
+    masks[1] = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, backslash)) |
+               ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, backslash)) << 32);
+    masks[2] = fp_avx2_ops_mask(lo) | ((uint64_t)fp_avx2_ops_mask(hi) << 32);
+}
+
+#ifdef FP_SIMD_HAVE_AVX512
+// AVX-512BW: 64 bytes per step; the tail uses a masked load, which does not
+// fault on the masked-off bytes past end
+FP_TARGET_AVX512 static inline __m512i fp_avx512_load(const char* p, const char* end, uint64_t* valid) {
+    size_t n = (size_t)(end - p);
+    *valid = n >= 64 ? ~0ULL : ((1ULL << n) - 1);
+    return _mm512_maskz_loadu_epi8((__mmask64)*valid, p);
+}
+
+FP_TARGET_AVX512 static const char* fp_skip_whitespace_avx512(const char* p, const char* end) {
+    while (p < end) {
+        uint64_t valid;
+        __m512i chunk = fp_avx512_load(p, end, &valid);
+        uint64_t ws = (uint64_t)(_mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(' ')) |
+                                 _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\t')) |
+                                 _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\n')) |
+                                 _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\r')));
+        uint64_t stop = ~ws & valid;
+        if (stop) return p + fp_ctz64(stop);
+        if (valid != ~0ULL) return end;
+        p += 64;
+    }
+    return end;
+}
+
+FP_TARGET_AVX512 static const char* fp_find_csv_delimiter_avx512(const char* p, const char* end) {
+    while (p < end) {
+        uint64_t valid;
+        __m512i chunk = fp_avx512_load(p, end, &valid);
+        uint64_t stop = (uint64_t)(_mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(',')) |
+                                   _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\n')) |
+                                   _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\r'))) & valid;
+        if (stop) return p + fp_ctz64(stop);
+        if (valid != ~0ULL) return end;
+        p += 64;
+    }
+    return end;
+}
+
+FP_TARGET_AVX512 static const char* fp_find_quote_avx512(const char* p, const char* end) {
+    while (p < end) {
+        uint64_t valid;
+        __m512i chunk = fp_avx512_load(p, end, &valid);
+        uint64_t stop = (uint64_t)(_mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('"')) |
+                                   _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\\'))) & valid;
+        if (stop) return p + fp_ctz64(stop);
+        if (valid != ~0ULL) return end;
+        p += 64;
+    }
+    return end;
+}
+
+FP_TARGET_AVX512 static size_t fp_count_newlines_avx512(const char* p, const char* end) {
+    size_t count = 0;
+    while (p < end) {
+        uint64_t valid;
+        __m512i chunk = fp_avx512_load(p, end, &valid);
+        count += fp_popcount64((uint64_t)_mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\n')) & valid);
+        p += 64;
+    }
+    return count;
+}
+
+FP_TARGET_AVX512 static void fp_json_classify_avx512(const char* block, uint64_t masks[3]) {
+    __m512i chunk = _mm512_loadu_si512((const void*)block);
+    masks[0] = (uint64_t)_mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('"'));
+    masks[1] = (uint64_t)_mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\\'));
+    masks[2] = (uint64_t)(_mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('{')) |
+                          _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('}')) |
+                          _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('[')) |
+                          _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(']')) |
+                          _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(':')) |
+                          _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(',')));
+}
+#endif
+
+static inline void fp_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuidex(info, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++) regs[i] = (uint32_t)info[i];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Register state the OS saves on context switch (XCR0)
+static inline uint64_t fp_xgetbv(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+static inline fp_simd_level_t fp_simd_detect(void) {
+    uint32_t regs[4];
+    fp_cpuid(0, 0, regs);
+    if (regs[0] < 7) return FP_SIMD_SSE2;
+    
+    fp_cpuid(1, 0, regs);
+    bool osxsave = (regs[2] >> 27) & 1;
+    bool avx = (regs[2] >> 28) & 1;
+    if (!osxsave || !avx) return FP_SIMD_SSE2;
+    
+    uint64_t xcr0 = fp_xgetbv();
+    if ((xcr0 & 0x6) != 0x6) return FP_SIMD_SSE2;          // XMM and YMM state
+    
+    fp_cpuid(7, 0, regs);
+    bool avx2 = (regs[1] >> 5) & 1;
+    bool avx512f = (regs[1] >> 16) & 1;
+    bool avx512bw = (regs[1] >> 30) & 1;
+    
+#ifdef FP_SIMD_HAVE_AVX512
+    if (avx512f && avx512bw && (xcr0 & 0xE6) == 0xE6) return FP_SIMD_AVX512;   // plus opmask and ZMM state
+#else
+    (void)avx512f; (void)avx512bw;
+#endif
+    return avx2 ? FP_SIMD_AVX2 : FP_SIMD_SSE2;
+}
+#endif // FP_SIMD_X86
+
+#ifdef FP_SIMD_NEON
+// NEON: narrow the 16-byte compare to a 64-bit mask with 4 bits per byte
+static inline uint64_t fp_neon_mask(uint8x16_t hits) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(hits), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+static const char* fp_skip_whitespace_neon(const char* p, const char* end) {
+    for (; p + 16 <= end; p += 16) {
+        uint8x16_t chunk = vld1q_u8((const uint8_t*)p);
+        uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(' ')), vceqq_u8(chunk, vdupq_n_u8('\t'))),
+                                 vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\n')), vceqq_u8(chunk, vdupq_n_u8('\r'))));
+        uint64_t stop = ~fp_neon_mask(ws);
+        if (stop) return p + (fp_ctz64(stop) >> 2);
+    }
+    return fp_skip_whitespace_scalar(p, end);
+}
+
+static const char* fp_find_csv_delimiter_neon(const char* p, const char* end) {
+    for (; p + 16 <= end; p += 16) {
+        uint8x16_t chunk = vld1q_u8((const uint8_t*)p);
+        uint8x16_t hit = vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(',')),
+                                  vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\n')), vceqq_u8(chunk, vdupq_n_u8('\r'))));
+        uint64_t stop = fp_neon_mask(hit);
+        if (stop) return p + (fp_ctz64(stop) >> 2);
+    }
+    return fp_find_csv_delimiter_scalar(p, end);
+}
+
+static const char* fp_find_quote_neon(const char* p, const char* end) {
+    for (; p + 16 <= end; p += 16) {
+        uint8x16_t chunk = vld1q_u8((const uint8_t*)p);
+        uint8x16_t hit = vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('"')), vceqq_u8(chunk, vdupq_n_u8('\\')));
+        uint64_t stop = fp_neon_mask(hit);
+        if (stop) return p + (fp_ctz64(stop) >> 2);
+    }
+    return fp_find_quote_scalar(p, end);
+}
+
+static size_t fp_count_newlines_neon(const char* p, const char* end) {
+    size_t count = 0;
+    for (; p + 16 <= end; p += 16) {
+        uint8x16_t hits = vceqq_u8(vld1q_u8((const uint8_t*)p), vdupq_n_u8('\n'));
+        count += vaddvq_u8(vandq_u8(hits, vdupq_n_u8(1)));
+    }
+    return count + fp_count_newlines_scalar(p, end);
+}
+
+// Full 64-bit movemask from four 16-byte compares
+static inline uint64_t fp_neon_movemask64(uint8x16_t m0, uint8x16_t m1, uint8x16_t m2, uint8x16_t m3) {
+    static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bits = vld1q_u8(weights);
+    uint8x16_t sum0 = vpaddq_u8(vandq_u8(m0, bits), vandq_u8(m1, bits));
+    uint8x16_t sum1 = vpaddq_u8(vandq_u8(m2, bits), vandq_u8(m3, bits));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+static void fp_json_classify_neon(const char* block, uint64_t masks[3]) {
+    uint8x16_t q[4], b[4], o[4];
+    for (int i = 0; i < 4; i++) {
+        uint8x16_t chunk = vld1q_u8((const uint8_t*)block + 16 * i);
+        q[i] = vceqq_u8(chunk, vdupq_n_u8('"'));
+        b[i] = vceqq_u8(chunk, vdupq_n_u8('\\'));
+        o[i] = vorrq_u8(vorrq_u8(vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('{')), vceqq_u8(chunk, vdupq_n_u8('}'))),
+                                 vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('[')), vceqq_u8(chunk, vdupq_n_u8(']')))),
+                        vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(':')), vceqq_u8(chunk, vdupq_n_u8(','))));
+    }
+    masks[0] = fp_neon_movemask64(q[0], q[1], q[2], q[3]);
+    masks[1] = fp_neon_movemask64(b[0], b[1], b[2], b[3]);
+    masks[2] = fp_neon_movemask64(o[0], o[1], o[2], o[3]);
+}
+#endif // FP_SIMD_NEON
+
+// Runtime dispatch. fp_kernels points at one constant table per level; it
+// starts at resolvers that detect the CPU, publish the table for the best
+// level and forward the call. Only the pointer is ever written, atomically,
+// so threads racing through the first scan all end up on the same table.
+typedef struct {
+    fp_scan_fn_t skip_whitespace;
+    fp_scan_fn_t find_csv_delimiter;
+    fp_scan_fn_t find_quote;
+    fp_json_classify_fn_t classify_json;
+    fp_count_fn_t count_newlines;
+    fp_simd_level_t level;
+} fp_simd_kernels_t;
+
+static const char* fp_resolve_skip_whitespace(const char* p, const char* end);
+static const char* fp_resolve_find_csv_delimiter(const char* p, const char* end);
+static const char* fp_resolve_find_quote(const char* p, const char* end);
+static void fp_resolve_classify_json(const char* block, uint64_t masks[3]);
+static size_t fp_resolve_count_newlines(const char* p, const char* end);
+
+static const fp_simd_kernels_t fp_kernels_resolve = {
+    fp_resolve_skip_whitespace, fp_resolve_find_csv_delimiter, fp_resolve_find_quote,
+    fp_resolve_classify_json, fp_resolve_count_newlines, FP_SIMD_SCALAR
+};
+
+static const fp_simd_kernels_t fp_kernels_scalar = {
+    fp_skip_whitespace_scalar, fp_find_csv_delimiter_scalar, fp_find_quote_scalar,
+    fp_json_classify_scalar, fp_count_newlines_scalar, FP_SIMD_SCALAR
+};
+
+#if defined(FP_SIMD_X86)
+static const fp_simd_kernels_t fp_kernels_sse2 = {
+    fp_skip_whitespace_sse2, fp_find_csv_delimiter_sse2, fp_find_quote_sse2,
+    fp_json_classify_sse2, fp_count_newlines_sse2, FP_SIMD_SSE2
+};
+
+static const fp_simd_kernels_t fp_kernels_avx2 = {
+    fp_skip_whitespace_avx2, fp_find_csv_delimiter_avx2, fp_find_quote_avx2,
+    fp_json_classify_avx2, fp_count_newlines_avx2, FP_SIMD_AVX2
+};
+
+#ifdef FP_SIMD_HAVE_AVX512
+static const fp_simd_kernels_t fp_kernels_avx512 = {
+    fp_skip_whitespace_avx512, fp_find_csv_delimiter_avx512, fp_find_quote_avx512,
+    fp_json_classify_avx512, fp_count_newlines_avx512, FP_SIMD_AVX512
+};
+#endif
+#elif defined(FP_SIMD_NEON)
+static const fp_simd_kernels_t fp_kernels_neon = {
+    fp_skip_whitespace_neon, fp_find_csv_delimiter_neon, fp_find_quote_neon,
+    fp_json_classify_neon, fp_count_newlines_neon, FP_SIMD_NEON
+};
+#endif
+
+static const fp_simd_kernels_t* volatile fp_kernels = &fp_kernels_resolve;
+
+// Acquire/release on the pointer (plain loads and stores on x86 and MSVC)
+static inline const fp_simd_kernels_t* fp_kernels_load(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return fp_kernels;
+#else
+    return __atomic_load_n(&fp_kernels, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void fp_kernels_store(const fp_simd_kernels_t* kernels) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    fp_kernels = kernels;
+#else
+    __atomic_store_n(&fp_kernels, kernels, __ATOMIC_RELEASE);
+#endif
+}
+
+// Best level this CPU and this build can run
+static inline fp_simd_level_t fp_simd_best_level(void) {
+#if defined(FP_SIMD_X86)
+    return fp_simd_detect();
+#elif defined(FP_SIMD_NEON)
+    return FP_SIMD_NEON;
+#else
+    return FP_SIMD_SCALAR;
+#endif
+}
+
+// Selects the kernels for a level (clamped to what the CPU supports) and
+// returns the level actually used. Mainly for benchmarks and tests;
+// normal code never needs to call it.
+static inline fp_simd_level_t fp_simd_set_level(fp_simd_level_t level) {
+    fp_simd_level_t best = fp_simd_best_level();
+    if (level > best) level = best;
+    
+    const fp_simd_kernels_t* k = &fp_kernels_scalar;
+#if defined(FP_SIMD_X86)
+    if (level >= FP_SIMD_SSE2) k = &fp_kernels_sse2;
+    if (level >= FP_SIMD_AVX2) k = &fp_kernels_avx2;
+#ifdef FP_SIMD_HAVE_AVX512
+    if (level >= FP_SIMD_AVX512) k = &fp_kernels_avx512;
+#endif
+#elif defined(FP_SIMD_NEON)
+    if (level >= FP_SIMD_NEON) k = &fp_kernels_neon;
+#endif
+    fp_kernels_store(k);
+    return k->level;
+}
+
+// Optional: pick kernels up front instead of on the first scan
+static inline fp_simd_level_t fp_simd_init(void) {
+    return fp_simd_set_level(FP_SIMD_AVX512);
+}
+
+static inline fp_simd_level_t fp_simd_level(void) {
+    if (fp_kernels_load() == &fp_kernels_resolve) fp_simd_init();
+    return fp_kernels_load()->level;
+}
+
+static const char* fp_resolve_skip_whitespace(const char* p, const char* end) {
+    fp_simd_init();
+    return fp_kernels_load()->skip_whitespace(p, end);
+}
+
+static const char* fp_resolve_find_csv_delimiter(const char* p, const char* end) {
+    fp_simd_init();
+    return fp_kernels_load()->find_csv_delimiter(p, end);
+}
+
+static const char* fp_resolve_find_quote(const char* p, const char* end) {
+    fp_simd_init();
+    return fp_kernels_load()->find_quote(p, end);
+}
+
+static void fp_resolve_classify_json(const char* block, uint64_t masks[3]) {
+    fp_simd_init();
+    fp_kernels_load()->classify_json(block, masks);
+}
+
+static size_t fp_resolve_count_newlines(const char* p, const char* end) {
+    fp_simd_init();
+    return fp_kernels_load()->count_newlines(p, end);
+}
+
+#ifdef FASTPARSE_SIMD_ENABLED
+static inline const char* fp_skip_whitespace_simd(const char* str, const char* end) {
+    return fp_kernels_load()->skip_whitespace(str, end);
+}
+#endif
+
+static inline const char* fp_skip_whitespace(const char* str, const char* end) {
+    // Most gaps are zero or one byte; test those before the indirect call
+    if (str >= end || !fp_is_whitespace(*str)) return str;
+    if (str + 1 >= end || !fp_is_whitespace(str[1])) return str + 1;
+    return fp_kernels_load()->skip_whitespace(str + 2, end);
+}
+
+// First ',', '\n' or '\r' at or after str
+static inline const char* fp_find_csv_delimiter(const char* str, const char* end) {
+    return fp_kernels_load()->find_csv_delimiter(str, end);
+}
+
+// First '"' or '\\' at or after str
+static inline const char* fp_find_quote(const char* str, const char* end) {
+    return fp_kernels_load()->find_quote(str, end);
+}
+
+static inline size_t fp_count_newlines(const char* str, const char* end) {
+    return fp_kernels_load()->count_newlines(str, end);
+}
+
+// ============================================================================
+// STRING VIEW OPERATIONS
+// ============================================================================
+
+#define FP_VIEW(literal) ((fp_view_t){.data = literal, .len = sizeof(literal) - 1})
+#define FP_VIEW_FROM_CSTR(str) ((fp_view_t){.data = str, .len = strlen(str)})
+#define FP_VIEW_EMPTY() ((fp_view_t){.data = NULL, .len = 0})
+
+static inline fp_view_t fp_view_substr(fp_view_t view, size_t start, size_t len) {
+    if (start >= view.len) return FP_VIEW_EMPTY();
+    if (start + len > view.len) len = view.len - start;
+    return (fp_view_t){.data = view.data + start, .len = len};
+}
+
+static inline bool fp_view_equals(fp_view_t a, fp_view_t b) {
+    return a.len == b.len && memcmp(a.data, b.data, a.len) == 0;
+}
+
+static inline bool fp_view_starts_with(fp_view_t view, fp_view_t prefix) {
+    return view.len >= prefix.len && memcmp(view.data, prefix.data, prefix.len) == 0;
+}
+
+static inline int fp_view_compare(fp_view_t a, fp_view_t b) {
+    size_t min_len = a.len < b.len ? a.len : b.len;
+    int result = memcmp(a.data, b.data, min_len);
+    if (result == 0) {
+        return a.len < b.len ? -1 : (a.len > b.len ? 1 : 0);
+    }
+    return result;
+}
+
+// Convert view to null-terminated string (WARNING: allocates memory)
+static inline char* fp_view_to_cstr(fp_view_t view) {
+    char* result = (char*)malloc(view.len + 1);
+    if (result) {
+        memcpy(result, view.data, view.len);
+        result[view.len] = '\0';
+    }
+    return result;
+}
+
+// ============================================================================
+// PARSER INITIALIZATION AND STATE
+// ============================================================================
+
+static inline fp_parser_t fp_init(const char* input, size_t len) {
+    return (fp_parser_t){
+        .start = input,
+        .current = input,
+        .end = input + len,
+        .line = 1,
+        .column = 1,
+        .position_mark = input,
+        .error_code = FP_OK,
+#ifdef FP_COMPACT_ERRORS
+        .error_arg = 0,
+        .error_msg = NULL,
+#else
+        .error_msg = {0},
+#endif
+        .error_offset = 0
+    };
+}
+
+static inline fp_parser_t fp_init_cstr(const char* input) {
+    return fp_init(input, strlen(input));
+}
+
+// Saved parser position for backtracking
+typedef struct {
+    const char* current;
+    size_t line;
+    size_t column;
+    const char* position_mark;
+} fp_position_t;
+
+static inline fp_position_t fp_save_position(const fp_parser_t* p) {
+    return (fp_position_t){
+        .current = p->current,
+        .line = p->line,
+        .column = p->column,
+        .position_mark = p->position_mark
+    };
+}
+
+static inline void fp_restore_position(fp_parser_t* p, fp_position_t pos) {
+    p->current = pos.current;
+    p->line = pos.line;
+    p->column = pos.column;
+    p->position_mark = pos.position_mark;
+}
+
+static inline bool fp_at_end(const fp_parser_t* p) {
+    return p->current >= p->end;
+}
+
+static inline size_t fp_remaining(const fp_parser_t* p) {
+    return p->end - p->current;
+}
+
+static inline char fp_peek(const fp_parser_t* p) {
+    return fp_at_end(p) ? '\0' : *p->current;
+}
+
+static inline char fp_advance(fp_parser_t* p) {
+    if (fp_at_end(p)) return '\0';
+    
+    char c = *p->current++;
+#ifndef FP_LAZY_POSITION
+    if (c == '\n') {
+        p->line++;
+        p->column = 1;
+    } else {
+        p->column++;
+    }
+#endif
+    return c;
+}
+
+// Line and column of the current position. Free when positions are tracked
+// eagerly; with FP_LAZY_POSITION it counts newlines since the last call
+// (or from the start if the parser moved backwards).
+static inline void fp_get_position(fp_parser_t* p, size_t* line, size_t* column) {
+#ifdef FP_LAZY_POSITION
+    if (p->current < p->position_mark) {
+        p->position_mark = p->start;
+        p->line = 1;
+        p->column = 1;
+    }
+    size_t newlines = fp_count_newlines(p->position_mark, p->current);
+    if (newlines) {
+        const char* line_start = p->current;
+        while (line_start > p->position_mark && line_start[-1] != '\n') line_start--;
+        p->line += newlines;
+        p->column = (size_t)(p->current - line_start) + 1;
+    } else {
+        p->column += (size_t)(p->current - p->position_mark);
+    }
+    p->position_mark = p->current;
+#endif
+    if (line) *line = p->line;
+    if (column) *column = p->column;
+}
+
+// ============================================================================
+// ERROR HANDLING
+// ============================================================================
+
+// With FP_COMPACT_ERRORS, msg must outlive the parser (a string literal)
+static inline void fp_set_error(fp_parser_t* p, fp_error_t code, const char* msg) {
+    p->error_code = code;
+    p->error_offset = (size_t)(p->current - p->start);
+#ifdef FP_COMPACT_ERRORS
+    p->error_msg = msg;
+    p->error_arg = 0;
+#else
+#ifdef FP_LAZY_POSITION
+    // Errors are rare; this is where line/column get paid for
+    fp_get_position(p, NULL, NULL);
+#endif
+    strncpy(p->error_msg, msg, sizeof(p->error_msg) - 1);
+    p->error_msg[sizeof(p->error_msg) - 1] = '\0';
+#endif
+}
+
+// fmt takes one int (%c, %d); compact mode defers the formatting to fp_format_error
+static inline void fp_set_error_arg(fp_parser_t* p, fp_error_t code, const char* fmt, int arg) {
+#ifdef FP_COMPACT_ERRORS
+    fp_set_error(p, code, fmt);
+    p->error_arg = arg;
+#else
+    char msg[sizeof(p->error_msg)];
+    snprintf(msg, sizeof(msg), fmt, arg);
+    fp_set_error(p, code, msg);
+#endif
+}
+
+static inline const char* fp_error_string(int code) {
+    switch (code) {
+        case FP_OK: return "No error";
+        case FP_ERROR_EOF: return "Unexpected end of input";
+        case FP_ERROR_INVALID_NUMBER: return "Invalid number";
+        case FP_ERROR_OVERFLOW: return "Number out of range";
+        case FP_ERROR_INVALID_ESCAPE: return "Invalid escape sequence";
+        case FP_ERROR_UNTERMINATED_STRING: return "Unterminated string";
+        case FP_ERROR_CUSTOM: return "Parse error";
+        case FP_ERROR_IO: return "I/O error";
+        case FP_ERROR_CAPACITY: return "Capacity exceeded";
+        default: return "Unknown error";
+    }
+}
+
+// Writes "<message> at line L, column C" for the last error into buffer and
+// returns it. The position is counted from the error offset here, so neither
+// mode pays for it until a message is wanted.
+static inline const char* fp_format_error(const fp_parser_t* p, char* buffer, size_t size) {
+    if (size == 0) return buffer;
+    if (p->error_code == FP_OK) {
+        snprintf(buffer, size, "%s", fp_error_string(FP_OK));
+        return buffer;
+    }
+    
+    const char* at = p->start + p->error_offset;
+    const char* line_start = at;
+    while (line_start > p->start && line_start[-1] != '\n') line_start--;
+    size_t line = 1 + fp_count_newlines(p->start, line_start);
+    size_t column = (size_t)(at - line_start) + 1;
+    
+#ifdef FP_COMPACT_ERRORS
+    char msg[128];
+    if (p->error_code == FP_ERROR_IO && p->error_msg) {
+        snprintf(msg, sizeof(msg), "%s (errno %d)", p->error_msg, p->error_arg);
+    } else if (p->error_msg) {
+        snprintf(msg, sizeof(msg), p->error_msg, p->error_arg);
+    } else {
+        snprintf(msg, sizeof(msg), "%s", fp_error_string(p->error_code));
+    }
+#else
+    const char* msg = p->error_msg[0] ? p->error_msg : fp_error_string(p->error_code);
+#endif
+    snprintf(buffer, size, "%s at line %zu, column %zu", msg, line, column);
+    return buffer;
+}
+
+static inline bool fp_has_error(const fp_parser_t* p) {
+    return p->error_code != FP_OK;
+}
+
+// ============================================================================
+// WHITESPACE AND DELIMITER HANDLING
+// ============================================================================
+
+// Moves to pos (at or after current), keeping line/column in step
+static inline void fp_advance_to(fp_parser_t* p, const char* pos) {
+#ifdef FP_LAZY_POSITION
+    p->current = pos;
+#else
+    const char* scan = p->current;
+    const char* last_newline = NULL;
+    while (scan < pos) {
+        const char* nl = (const char*)memchr(scan, '\n', (size_t)(pos - scan));
+        if (!nl) break;
+        p->line++;
+        last_newline = nl;
+        scan = nl + 1;
+    }
+    if (last_newline) {
+        p->column = (size_t)(pos - last_newline);
+    } else {
+        p->column += (size_t)(pos - p->current);
+    }
+    p->current = pos;
+#endif
+}
+
+// Moves back to pos (at or before current); only used on error paths
+static inline void fp_retreat_to(fp_parser_t* p, const char* pos) {
+#ifndef FP_LAZY_POSITION
+    size_t newlines = 0;
+    for (const char* s = pos; s < p->current; s++) newlines += (*s == '\n');
+    if (newlines) {
+        const char* line_start = pos;
+        while (line_start > p->start && line_start[-1] != '\n') line_start--;
+        p->line -= newlines;
+        p->column = (size_t)(pos - line_start) + 1;
+    } else {
+        p->column -= (size_t)(p->current - pos);
+    }
+#endif
+    p->current = pos;
+}
+
+// Moves to pos when the bytes in between hold no newline
+static inline void fp_advance_same_line(fp_parser_t* p, const char* pos) {
+#ifndef FP_LAZY_POSITION
+    p->column += (size_t)(pos - p->current);
+#endif
+    p->current = pos;
+}
+
+static inline void fp_skip_ws(fp_parser_t* p) {
+    fp_advance_to(p, fp_skip_whitespace(p->current, p->end));
+}
+
+static inline bool fp_match_char(fp_parser_t* p, char expected) {
+    if (fp_peek(p) == expected) {
+        fp_advance(p);
+        return true;
+    }
+    return false;
+}
+
+static inline bool fp_match_str(fp_parser_t* p, fp_view_t expected) {
+    if (fp_remaining(p) >= expected.len && 
+        memcmp(p->current, expected.data, expected.len) == 0) {
+        p->current += expected.len;
+#ifndef FP_LAZY_POSITION
+        p->column += expected.len;
+#endif
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// ULTRA-FAST NUMBER PARSING
+// ============================================================================
+
+// Locale-independent, unlike isdigit
+static inline bool fp_is_digit(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+#ifdef FP_LITTLE_ENDIAN
+static inline uint64_t fp_load64(const char* p) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// Number of leading digit bytes in an 8-byte word (8 if all are digits).
+// Carries out of a non-digit byte may flag later bytes too, which is fine
+// since only the first flagged byte matters.
+static inline unsigned fp_swar_digit_count(uint64_t word) {
+    uint64_t offset = word ^ 0x3030303030303030ULL;                 // digits become 0..9
+    uint64_t non_digit = ((offset + 0x7676767676767676ULL) | offset) & 0x8080808080808080ULL;
+    return non_digit ? fp_ctz64(non_digit) >> 3 : 8;
+}
+
+// Eight ASCII digits, first digit in the lowest byte, to their value
+static inline uint32_t fp_swar_parse8(uint64_t word) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL;    // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ULL;    // 1 + (10000 << 32)
+    word -= 0x3030303030303030ULL;
+    word = (word * 10) + (word >> 8);
+    return (uint32_t)((((word & mask) * mul1) + (((word >> 16) & mask) * mul2)) >> 32);
+}
+#endif
+
+static inline bool fp_parse_int64(fp_parser_t* p, int64_t* result) {
+    fp_skip_ws(p);
+    
+    if (fp_at_end(p)) {
+        fp_set_error(p, FP_ERROR_EOF, "Expected number");
+        return false;
+    }
+    
+    bool negative = false;
+    if (fp_peek(p) == '-') {
+        negative = true;
+        fp_advance(p);
+    } else if (fp_peek(p) == '+') {
+        fp_advance(p);
+    }
+    
+    if (!fp_is_digit(fp_peek(p))) {
+        fp_set_error(p, FP_ERROR_INVALID_NUMBER, "Expected digit");
+        return false;
+    }
+    
+    // Leading zeros do not count toward the 19-digit limit
+    const char* s = p->current;
+    while (s < p->end && *s == '0') s++;
+    
+    uint64_t value = 0;
+    size_t digits = 0;
+    
+#ifdef FP_LITTLE_ENDIAN
+    // Eight digits per step while a full word is left in the buffer
+    while (p->end - s >= 8) {
+        uint64_t word = fp_load64(s);
+        unsigned count = fp_swar_digit_count(word);
+        if (count == 8) {
+            value = value * 100000000ULL + fp_swar_parse8(word);
+        } else if (count > 0) {
+            // Left-pad the partial run with '0' bytes up to a full word
+            uint64_t padded = (word << (8 * (8 - count))) | (0x3030303030303030ULL >> (8 * count));
+            static const uint64_t pow10[8] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+            value = value * pow10[count] + fp_swar_parse8(padded);
+        }
+        digits += count;
+        s += count;
+        if (count < 8 || digits > 19) break;
+    }
+#endif
+    
+    // Byte loop for the tail of the buffer (and big-endian targets)
+    while (s < p->end && fp_is_digit(*s) && digits <= 19) {
+        value = value * 10 + (uint64_t)(*s - '0');
+        digits++;
+        s++;
+    }
+    
+    // One overflow check: more than 19 digits never fits, 19 might not
+    const uint64_t max_val = negative ? (uint64_t)INT64_MAX + 1 : INT64_MAX;
+    if (digits > 19 || value > max_val) {
+        while (s < p->end && fp_is_digit(*s)) s++;
+        fp_advance_same_line(p, s);
+        fp_set_error(p, FP_ERROR_OVERFLOW, "Integer overflow");
+        return false;
+    }
+    
+    fp_advance_same_line(p, s);
+    *result = negative ? (int64_t)(0 - value) : (int64_t)value;
+    return true;
+}
+
+// Double parsing: Clinger's exact fast path for small inputs, Eisel-Lemire
+// for everything else that fits 19 significant digits, and a bounded strtod
+// for the rest (longer mantissas that round ambiguously, inf/nan, hex).
+
+// 128-bit approximations of 5^q for q in [-342, 308], high word first
+#define FP_POW5_MIN_EXP (-342)
+#define FP_POW5_MAX_EXP 308
+
+static const uint64_t fp_pow5_128[] = {
+    0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL,
+    0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL,
+    0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL,
+    0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL,
+    0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL,
+    0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL,
+    0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL,
+    0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL,
+    0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL,
+    0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL,
+    0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL,
+    0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL,
+    0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL,
+    0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL,
+    0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL,
+    0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL,
+    0x84A57695FE98746DULL, 0x014BB630F7604B57ULL,
+    0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL,
+    0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL,
+    0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL,
+    0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL,
+    0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL,
+    0xFD00B897478238D0ULL, 0x8920B098955522B4ULL,
+    0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL,
+    0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL,
+    0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL,
+    0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL,
+    0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL,
+    0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL,
+    0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL,
+    0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL,
+    0xEBA09271E88D976BULL, 0xF7864A44C633682EULL,
+    0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL,
+    0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL,
+    0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL,
+    0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL,
+    0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL,
+    0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL,
+    0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL,
+    0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL,
+    0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL,
+    0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL,
+    0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL,
+    0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL,
+    0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL,
+    0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL,
+    0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL,
+    0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL,
+    0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL,
+    0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL,
+    0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL,
+    0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL,
+    0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL,
+    0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL,
+    0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL,
+    0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL,
+    0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL,
+    0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL,
+    0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL,
+    0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL,
+    0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL,
+    0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL,
+    0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL,
+    0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL,
+    0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL,
+    0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL,
+    0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL,
+    0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL,
+    0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL,
+    0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL,
+    0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL,
+    0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL,
+    0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL,
+    0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL,
+    0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL,
+    0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL,
+    0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL,
+    0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL,
+    0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL,
+    0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL,
+    0xC987434744AC874EULL, 0xA327FFB266B56220ULL,
+    0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL,
+    0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL,
+    0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL,
+    0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL,
+    0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL,
+    0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL,
+    0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL,
+    0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL,
+    0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL,
+    0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL,
+    0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL,
+    0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL,
+    0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL,
+    0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL,
+    0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL,
+    0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL,
+    0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL,
+    0xAECC49914078536DULL, 0x58FAE9F773886E18ULL,
+    0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL,
+    0x888F99797A5E012DULL, 0x6D8406C952429603ULL,
+    0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL,
+    0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL,
+    0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL,
+    0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL,
+    0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL,
+    0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL,
+    0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL,
+    0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL,
+    0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL,
+    0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL,
+    0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL,
+    0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL,
+    0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL,
+    0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL,
+    0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL,
+    0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL,
+    0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL,
+    0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL,
+    0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL,
+    0xB913179899F68584ULL, 0x28E2557B59846E3FULL,
+    0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL,
+    0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL,
+    0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL,
+    0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL,
+    0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL,
+    0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL,
+    0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL,
+    0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL,
+    0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL,
+    0xD77485CB25823AC7ULL, 0x7D633293366B828BULL,
+    0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL,
+    0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL,
+    0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL,
+    0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL,
+    0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL,
+    0xCD795BE870516656ULL, 0x67902E276C921F8BULL,
+    0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL,
+    0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL,
+    0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL,
+    0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL,
+    0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL,
+    0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL,
+    0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL,
+    0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL,
+    0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL,
+    0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL,
+    0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL,
+    0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL,
+    0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL,
+    0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL,
+    0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL,
+    0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL,
+    0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL,
+    0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL,
+    0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL,
+    0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL,
+    0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL,
+    0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL,
+    0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL,
+    0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL,
+    0xD47487CC8470652BULL, 0x7647C3200069671FULL,
+    0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL,
+    0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL,
+    0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL,
+    0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL,
+    0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL,
+    0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL,
+    0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL,
+    0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL,
+    0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL,
+    0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL,
+    0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL,
+    0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL,
+    0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL,
+    0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL,
+    0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL,
+    0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL,
+    0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL,
+    0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL,
+    0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL,
+    0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL,
+    0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL,
+    0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL,
+    0x8C974F7383725573ULL, 0x1E414218C73A13FBULL,
+    0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL,
+    0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL,
+    0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL,
+    0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL,
+    0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL,
+    0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL,
+    0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL,
+    0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL,
+    0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL,
+    0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL,
+    0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL,
+    0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL,
+    0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL,
+    0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL,
+    0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL,
+    0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL,
+    0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL,
+    0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL,
+    0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL,
+    0xBE89523386091465ULL, 0xF6BBB397F1135823ULL,
+    0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL,
+    0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL,
+    0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL,
+    0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL,
+    0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL,
+    0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL,
+    0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL,
+    0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL,
+    0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL,
+    0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL,
+    0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL,
+    0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL,
+    0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL,
+    0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL,
+    0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL,
+    0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL,
+    0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL,
+    0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL,
+    0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL,
+    0x811CCC668829B887ULL, 0x0806357D5A3F525FULL,
+    0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL,
+    0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL,
+    0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL,
+    0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL,
+    0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL,
+    0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL,
+    0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL,
+    0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL,
+    0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL,
+    0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL,
+    0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL,
+    0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL,
+    0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL,
+    0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL,
+    0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL,
+    0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL,
+    0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL,
+    0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL,
+    0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL,
+    0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL,
+    0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL,
+    0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL,
+    0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL,
+    0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL,
+    0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL,
+    0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL,
+    0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL,
+    0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL,
+    0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL,
+    0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL,
+    0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL,
+    0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL,
+    0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL,
+    0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL,
+    0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL,
+    0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL,
+    0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL,
+    0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL,
+    0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL,
+    0xED246723473E3813ULL, 0x290123E9AAB23B68ULL,
+    0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL,
+    0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL,
+    0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL,
+    0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL,
+    0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL,
+    0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL,
+    0x8D590723948A535FULL, 0x579C487E5A38AD0EULL,
+    0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL,
+    0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL,
+    0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL,
+    0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL,
+    0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL,
+    0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL,
+    0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL,
+    0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL,
+    0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL,
+    0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL,
+    0xCDB02555653131B6ULL, 0x3792F412CB06794DULL,
+    0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL,
+    0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL,
+    0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL,
+    0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL,
+    0x9CED737BB6C4183DULL, 0x55464DD69685606BULL,
+    0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL,
+    0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL,
+    0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL,
+    0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL,
+    0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL,
+    0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL,
+    0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL,
+    0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL,
+    0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL,
+    0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL,
+    0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL,
+    0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL,
+    0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL,
+    0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL,
+    0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL,
+    0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL,
+    0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL,
+    0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL,
+    0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL,
+    0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL,
+    0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL,
+    0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL,
+    0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL,
+    0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL,
+    0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL,
+    0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL,
+    0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL,
+    0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL,
+    0xC612062576589DDAULL, 0x95364AFE032A819EULL,
+    0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL,
+    0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL,
+    0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL,
+    0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL,
+    0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL,
+    0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL,
+    0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL,
+    0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL,
+    0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL,
+    0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL,
+    0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL,
+    0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL,
+    0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL,
+    0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL,
+    0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL,
+    0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL,
+    0x89705F4136B4A597ULL, 0x31680A88F8953031ULL,
+    0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL,
+    0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL,
+    0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL,
+    0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL,
+    0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL,
+    0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL,
+    0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL,
+    0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL,
+    0x8000000000000000ULL, 0x0000000000000000ULL,
+    0xA000000000000000ULL, 0x0000000000000000ULL,
+    0xC800000000000000ULL, 0x0000000000000000ULL,
+    0xFA00000000000000ULL, 0x0000000000000000ULL,
+    0x9C40000000000000ULL, 0x0000000000000000ULL,
+    0xC350000000000000ULL, 0x0000000000000000ULL,
+    0xF424000000000000ULL, 0x0000000000000000ULL,
+    0x9896800000000000ULL, 0x0000000000000000ULL,
+    0xBEBC200000000000ULL, 0x0000000000000000ULL,
+    0xEE6B280000000000ULL, 0x0000000000000000ULL,
+    0x9502F90000000000ULL, 0x0000000000000000ULL,
+    0xBA43B74000000000ULL, 0x0000000000000000ULL,
+    0xE8D4A51000000000ULL, 0x0000000000000000ULL,
+    0x9184E72A00000000ULL, 0x0000000000000000ULL,
+    0xB5E620F480000000ULL, 0x0000000000000000ULL,
+    0xE35FA931A0000000ULL, 0x0000000000000000ULL,
+    0x8E1BC9BF04000000ULL, 0x0000000000000000ULL,
+    0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL,
+    0xDE0B6B3A76400000ULL, 0x0000000000000000ULL,
+    0x8AC7230489E80000ULL, 0x0000000000000000ULL,
+    0xAD78EBC5AC620000ULL, 0x0000000000000000ULL,
+    0xD8D726B7177A8000ULL, 0x0000000000000000ULL,
+    0x878678326EAC9000ULL, 0x0000000000000000ULL,
+    0xA968163F0A57B400ULL, 0x0000000000000000ULL,
+    0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL,
+    0x84595161401484A0ULL, 0x0000000000000000ULL,
+    0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL,
+    0xCECB8F27F4200F3AULL, 0x0000000000000000ULL,
+    0x813F3978F8940984ULL, 0x4000000000000000ULL,
+    0xA18F07D736B90BE5ULL, 0x5000000000000000ULL,
+    0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL,
+    0xFC6F7C4045812296ULL, 0x4D00000000000000ULL,
+    0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL,
+    0xC5371912364CE305ULL, 0x6C28000000000000ULL,
+    0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL,
+    0x9A130B963A6C115CULL, 0x3C7F400000000000ULL,
+    0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL,
+    0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL,
+    0x96769950B50D88F4ULL, 0x1314448000000000ULL,
+    0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL,
+    0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL,
+    0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL,
+    0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL,
+    0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL,
+    0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL,
+    0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL,
+    0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL,
+    0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL,
+    0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL,
+    0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL,
+    0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL,
+    0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL,
+    0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL,
+    0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL,
+    0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL,
+    0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL,
+    0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL,
+    0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL,
+    0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL,
+    0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL,
+    0x9F4F2726179A2245ULL, 0x01D762422C946590ULL,
+    0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL,
+    0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL,
+    0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL,
+    0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL,
+    0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL,
+    0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL,
+    0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL,
+    0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL,
+    0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL,
+    0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL,
+    0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL,
+    0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL,
+    0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL,
+    0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL,
+    0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL,
+    0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL,
+    0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL,
+    0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL,
+    0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL,
+    0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL,
+    0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL,
+    0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL,
+    0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL,
+    0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL,
+    0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL,
+    0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL,
+    0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL,
+    0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL,
+    0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL,
+    0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL,
+    0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL,
+    0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL,
+    0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL,
+    0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL,
+    0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL,
+    0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL,
+    0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL,
+    0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL,
+    0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL,
+    0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL,
+    0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL,
+    0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL,
+    0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL,
+    0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL,
+    0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL,
+    0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL,
+    0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL,
+    0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL,
+    0x884134FE908658B2ULL, 0x3109058D147FDCDDULL,
+    0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL,
+    0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL,
+    0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL,
+    0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL,
+    0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL,
+    0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL,
+    0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL,
+    0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL,
+    0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL,
+    0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL,
+    0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL,
+    0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL,
+    0x9AE757596946075FULL, 0x3375788DE9B06958ULL,
+    0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL,
+    0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL,
+    0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL,
+    0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL,
+    0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL,
+    0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL,
+    0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL,
+    0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL,
+    0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL,
+    0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL,
+    0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL,
+    0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL,
+    0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL,
+    0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL,
+    0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL,
+    0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL,
+    0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL,
+    0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL,
+    0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL,
+    0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL,
+    0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL,
+    0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL,
+    0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL,
+    0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL,
+    0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL,
+    0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL,
+    0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL,
+    0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL,
+    0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL,
+    0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL,
+    0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL,
+    0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL,
+    0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL,
+    0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL,
+    0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL,
+    0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL,
+    0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL,
+    0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL,
+    0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL,
+    0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL,
+    0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL,
+    0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL,
+    0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL,
+    0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL,
+    0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL,
+    0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL,
+    0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL,
+    0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL,
+    0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL,
+    0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL,
+    0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL,
+    0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL,
+    0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL,
+    0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL,
+    0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL,
+    0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL,
+    0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL,
+    0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL,
+    0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL,
+    0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL,
+    0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL,
+    0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL,
+    0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL,
+    0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL,
+    0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL,
+    0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL,
+    0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL,
+    0x8FA475791A569D10ULL, 0xF96E017D694487BCULL,
+    0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL,
+    0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL,
+    0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL,
+    0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL,
+    0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL,
+    0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL,
+    0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL,
+    0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL,
+    0x85C7056562757456ULL, 0xF6872D5667844E49ULL,
+    0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL,
+    0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL,
+    0x82A45B450226B39CULL, 0xECC0024661173473ULL,
+    0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL,
+    0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL,
+    0xFF290242C83396CEULL, 0x7E67047175A15271ULL,
+    0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL,
+    0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL,
+    0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL,
+    0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL,
+    0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL,
+    0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL,
+    0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL,
+    0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL,
+    0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL,
+    0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL,
+    0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL,
+    0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL,
+    0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL,
+    0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL,
+    0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL,
+    0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL,
+    0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL,
+    0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL,
+    0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL,
+    0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL,
+    0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL,
+    0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL,
+    0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL,
+    0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL,
+    0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL,
+    0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL,
+    0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL,
+    0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL,
+    0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL,
+    0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL,
+    0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL,
+    0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL,
+    0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL,
+    0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL,
+    0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL,
+    0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL,
+    0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL,
+    0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL,
+    0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL,
+    0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL,
+    0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL,
+    0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL,
+    0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL,
+    0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL,
+    0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL,
+    0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL,
+    0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL,
+    0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL,
+    0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL,
+    0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL,
+    0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL,
+    0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL,
+    0x8533285C936B35DEULL, 0xD53A88958F87275FULL,
+    0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL,
+    0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL,
+    0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL,
+    0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL,
+    0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL,
+    0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL,
+    0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL,
+    0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL,
+    0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL,
+    0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL,
+    0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL,
+    0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL,
+    0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL,
+    0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL,
+    0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL,
+    0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL,
+    0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL,
+    0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL,
+    0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL,
+    0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL,
+    0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL,
+    0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL,
+    0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL,
+    0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL,
+    0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL,
+    0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL,
+    0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL,
+    0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL,
+    0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL,
+    0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL,
+    0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL,
+    0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL,
+    0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL,
+    0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL,
+    0xA0555E361951C366ULL, 0xD7E105BCC332621FULL,
+    0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL,
+    0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL,
+    0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL,
+    0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL,
+    0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL,
+    0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL,
+    0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL,
+    0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL,
+    0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL,
+    0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL,
+    0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL,
+    0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL,
+    0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL,
+    0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL,
+    0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL
+};
+
+static inline uint64_t fp_mul128(uint64_t a, uint64_t b, uint64_t* high) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *high = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, high);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32, b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    *high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+static inline unsigned fp_clz64(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return 63 - (unsigned)index;
+#else
+    return (unsigned)__builtin_clzll(x);
+#endif
+}
+
+// Eisel-Lemire: w * 10^q to IEEE-754 binary64 bits (without sign), correctly
+// rounded for any nonzero w and q in range
+static inline uint64_t fp_eisel_lemire(uint64_t w, int64_t q) {
+    const int mantissa_bits = 52;
+    if (q < FP_POW5_MIN_EXP) return 0;
+    if (q > FP_POW5_MAX_EXP) return 0x7FFULL << mantissa_bits;
+    
+    unsigned lz = fp_clz64(w);
+    w <<= lz;
+    
+    // Product with the 128-bit power; the low half only matters when the
+    // bits below the mantissa are all ones
+    size_t index = 2 * (size_t)(q - FP_POW5_MIN_EXP);
+    uint64_t high;
+    uint64_t low = fp_mul128(w, fp_pow5_128[index], &high);
+    const uint64_t precision_mask = 0xFFFFFFFFFFFFFFFFULL >> (mantissa_bits + 3);
+    if ((high & precision_mask) == precision_mask) {
+        uint64_t second_high;
+        fp_mul128(w, fp_pow5_128[index + 1], &second_high);
+        low += second_high;
+        if (second_high > low) high++;
+    }
+    
+    int upperbit = (int)(high >> 63);
+    int shift = upperbit + 64 - mantissa_bits - 3;
+    uint64_t mantissa = high >> shift;
+    // floor(q * log2(10)) + 63, plus the normalization shifts, plus the bias
+    int32_t power2 = (int32_t)(((152170 + 65536) * q) >> 16) + 63 + upperbit - (int32_t)lz + 1023;
+    
+    if (power2 <= 0) {
+        // Subnormal: shift down to the fixed exponent and round
+        if (-power2 + 1 >= 64) return 0;
+        mantissa >>= -power2 + 1;
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        power2 = (mantissa < (1ULL << mantissa_bits)) ? 0 : 1;
+        return (mantissa & ((1ULL << mantissa_bits) - 1)) | ((uint64_t)power2 << mantissa_bits);
+    }
+    
+    // Exactly halfway between two doubles: round to even instead of up
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == high) {
+        mantissa &= ~1ULL;
+    }
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    if (mantissa >= (2ULL << mantissa_bits)) {
+        mantissa = 1ULL << mantissa_bits;
+        power2++;
+    }
+    mantissa &= ~(1ULL << mantissa_bits);
+    if (power2 >= 0x7FF) return 0x7FFULL << mantissa_bits;
+    return mantissa | ((uint64_t)power2 << mantissa_bits);
+}
+
+static inline double fp_bits_to_double(uint64_t bits) {
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+// strtod on a bounded, NUL-terminated copy, with '.' swapped for the locale's
+// decimal point. Returns the number of input bytes consumed.
+static inline size_t fp_strtod_bounded(const char* start, const char* end, double* result) {
+    char buffer[512];
+    size_t len = 0;
+    while (start + len < end && len < sizeof(buffer) - 1) {
+        char c = start[len];
+        if (!isalnum((unsigned char)c) && c != '.' && c != '+' && c != '-' && c != '(' && c != ')' && c != '_') break;
+        buffer[len++] = c;
+    }
+    buffer[len] = '\0';
+    
+    const char* decimal_point = localeconv()->decimal_point;
+    if (decimal_point && decimal_point[0] != '.' && decimal_point[0] != '\0' && decimal_point[1] == '\0') {
+        for (size_t i = 0; i < len; i++) {
+            if (buffer[i] == '.') buffer[i] = decimal_point[0];
+        }
+    }
+    
+    char* end_ptr;
+    *result = strtod(buffer, &end_ptr);
+    return (size_t)(end_ptr - buffer);
+}
+
+static inline bool fp_parse_double(fp_parser_t* p, double* result) {
+    fp_skip_ws(p);
+    
+    static const double exact_pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    
+    const char* start = p->current;
+    const char* end = p->end;
+    const char* s = start;
+    
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        s++;
+    }
+    
+    // Up to 19 significant digits go into w; the exponent absorbs the rest
+    uint64_t w = 0;
+    int significant = 0;
+    int64_t exponent = 0;
+    bool truncated = false;
+    
+    const char* int_start = s;
+    for (; s < end && fp_is_digit(*s); s++) {
+        unsigned digit = (unsigned)(*s - '0');
+        if (significant == 0 && digit == 0) continue;
+        if (significant < 19) {
+            w = w * 10 + digit;
+            significant++;
+        } else {
+            exponent++;
+            truncated |= (digit != 0);
+        }
+    }
+    size_t int_digits = (size_t)(s - int_start);
+    
+    size_t frac_digits = 0;
+    if (s < end && *s == '.') {
+        const char* frac_start = ++s;
+        for (; s < end && fp_is_digit(*s); s++) {
+            unsigned digit = (unsigned)(*s - '0');
+            if (significant == 0 && digit == 0) {
+                exponent--;
+            } else if (significant < 19) {
+                w = w * 10 + digit;
+                significant++;
+                exponent--;
+            } else {
+                truncated |= (digit != 0);
+            }
+        }
+        frac_digits = (size_t)(s - frac_start);
+    }
+    
+    if (int_digits + frac_digits == 0) {
+        // inf, nan and friends, or not a number at all
+        if (s < end && (*s == 'i' || *s == 'I' || *s == 'n' || *s == 'N')) {
+            size_t consumed = fp_strtod_bounded(start, end, result);
+            if (consumed > 0) {
+                fp_advance_same_line(p, start + consumed);
+                return true;
+            }
+        }
+        fp_set_error(p, FP_ERROR_INVALID_NUMBER, "Expected number");
+        return false;
+    }
+    
+    // Hex floats are rare enough to leave to strtod
+    if (int_digits == 1 && frac_digits == 0 && s[-1] == '0' && s < end && (*s == 'x' || *s == 'X')) {
+        size_t consumed = fp_strtod_bounded(start, end, result);
+        fp_advance_same_line(p, start + consumed);
+        return true;
+    }
+    
+    // The exponent only counts if digits follow it
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const char* e = s + 1;
+        bool exp_negative = false;
+        if (e < end && (*e == '-' || *e == '+')) {
+            exp_negative = (*e == '-');
+            e++;
+        }
+        if (e < end && fp_is_digit(*e)) {
+            int64_t exp_value = 0;
+            for (; e < end && fp_is_digit(*e); e++) {
+                if (exp_value < 100000) exp_value = exp_value * 10 + (*e - '0');
+            }
+            exponent += exp_negative ? -exp_value : exp_value;
+            s = e;
+        }
+    }
+    
+    double value;
+    if (w == 0) {
+        value = 0.0;
+    } else if (!truncated && exponent >= -22 && exponent <= 22 && w <= (1ULL << 53)) {
+        // Clinger: both operands are exact, so one IEEE operation rounds correctly
+        value = (double)w;
+        value = exponent < 0 ? value / exact_pow10[-exponent] : value * exact_pow10[exponent];
+    } else {
+        uint64_t bits = fp_eisel_lemire(w, exponent);
+        // Dropped digits put the true value between w and w+1; if both round
+        // the same way that is the answer, otherwise ask strtod
+        if (truncated && fp_eisel_lemire(w + 1, exponent) != bits) {
+            size_t consumed = fp_strtod_bounded(start, end, &value);
+            if (consumed == (size_t)(s - start)) {
+                fp_advance_same_line(p, s);
+                *result = value;
+                return true;
+            }
+        }
+        value = fp_bits_to_double(bits);
+    }
+    
+    fp_advance_same_line(p, s);
+    *result = negative ? -value : value;
+    return true;
+}
+
+// ============================================================================
+// ARENA
+// ============================================================================
+// Bump allocator over a caller-supplied buffer (stack, static or heap; the
+// arena never allocates). Everything is released at once with fp_arena_reset.
+
+typedef struct {
+    char* base;
+    size_t size;
+    size_t used;
+} fp_arena_t;
+
+static inline fp_arena_t fp_arena_init(void* buffer, size_t size) {
+    return (fp_arena_t){.base = (char*)buffer, .size = size, .used = 0};
+}
+
+// 16-byte aligned; NULL when the buffer is full
+static inline void* fp_arena_alloc(fp_arena_t* arena, size_t size) {
+    size_t offset = (arena->used + 15) & ~(size_t)15;
+    if (!arena->base || offset > arena->size || size > arena->size - offset) return NULL;
+    arena->used = offset + size;
+    return arena->base + offset;
+}
+
+static inline void fp_arena_reset(fp_arena_t* arena) {
+    arena->used = 0;
+}
+
+// ============================================================================
+// STRING PARSING WITH ESCAPE SEQUENCES
+// ============================================================================
+
+// Jumps quote to quote/backslash with the SIMD scanner; *escaped reports
+// whether the body holds any backslash
+static inline bool fp_scan_quoted_string(fp_parser_t* p, fp_view_t* result, bool* escaped) {
+    fp_skip_ws(p);
+    
+    if (!fp_match_char(p, '"')) {
+        fp_set_error(p, FP_ERROR_UNTERMINATED_STRING, "Expected opening quote");
+        return false;
+    }
+    
+    const char* start = p->current;
+    const char* s = start;
+    *escaped = false;
+    
+    for (;;) {
+        s = fp_find_quote(s, p->end);
+        if (s >= p->end) break;
+        if (*s == '"') {
+            fp_advance_to(p, s + 1);
+            *result = (fp_view_t){.data = start, .len = (size_t)(s - start)};
+            return true;
+        }
+        *escaped = true;
+        s += 2; // Backslash and the escaped character
+        if (s > p->end) break;
+    }
+    
+    fp_advance_to(p, p->end);
+    fp_set_error(p, FP_ERROR_UNTERMINATED_STRING, "Expected closing quote");
+    return false;
+}
+
+static inline bool fp_parse_quoted_string(fp_parser_t* p, fp_view_t* result) {
+    bool escaped;
+    return fp_scan_quoted_string(p, result, &escaped);
+}
+
+static inline int fp_hex4(const char* s) {
+    int value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = s[i];
+        int digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return -1;
+        value = (value << 4) | digit;
+    }
+    return value;
+}
+
+static inline char* fp_utf8_encode(char* out, uint32_t cp) {
+    if (cp < 0x80) {
+        *out++ = (char)cp;
+    } else if (cp < 0x800) {
+        *out++ = (char)(0xC0 | (cp >> 6));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = (char)(0xE0 | (cp >> 12));
+        *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = (char)(0xF0 | (cp >> 18));
+        *out++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+// Unescapes raw (a string body without its quotes) into out, which must hold
+// raw.len bytes; decoding never grows. Returns the decoded length, or -1 with
+// *bad at the offending escape.
+static inline ptrdiff_t fp_unescape(fp_view_t raw, char* out, const char** bad) {
+    const char* s = raw.data;
+    const char* end = raw.data + raw.len;
+    char* o = out;
+    
+    while (s < end) {
+        const char* slash = fp_find_quote(s, end);
+        memcpy(o, s, (size_t)(slash - s));
+        o += slash - s;
+        if (slash >= end) break;
+        
+        *bad = slash;
+        if (slash + 1 >= end) return -1;
+        s = slash + 2;
+        switch (slash[1]) {
+            case '"':  *o++ = '"'; break;
+            case '\\': *o++ = '\\'; break;
+            case '/':  *o++ = '/'; break;
+            case 'b':  *o++ = '\b'; break;
+            case 'f':  *o++ = '\f'; break;
+            case 'n':  *o++ = '\n'; break;
+            case 'r':  *o++ = '\r'; break;
+            case 't':  *o++ = '\t'; break;
+            case 'u': {
+                int unit = end - s >= 4 ? fp_hex4(s) : -1;
+                if (unit < 0) return -1;
+                s += 4;
+                uint32_t cp = (uint32_t)unit;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // High surrogate: must be followed by \u + low surrogate
+                    int low = (end - s >= 6 && s[0] == '\\' && s[1] == 'u') ? fp_hex4(s + 2) : -1;
+                    if (low < 0xDC00 || low > 0xDFFF) return -1;
+                    s += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + ((uint32_t)low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return -1;
+                }
+                o = fp_utf8_encode(o, cp);
+                break;
+            }
+            default:
+                return -1;
+        }
+    }
+    return o - out;
+}
+
+// Parses a quoted string with its escapes decoded (\uXXXX and surrogate pairs
+// become UTF-8). Without escapes the result is the zero-copy view into the
+// input; otherwise it is decoded into the arena.
+static inline bool fp_parse_string_decoded(fp_parser_t* p, fp_arena_t* arena, fp_view_t* result) {
+    fp_view_t raw;
+    bool escaped;
+    if (!fp_scan_quoted_string(p, &raw, &escaped)) return false;
+    
+    if (!escaped) {
+        *result = raw;
+        return true;
+    }
+    
+    char* out = (char*)fp_arena_alloc(arena, raw.len);
+    if (!out) {
+        fp_set_error(p, FP_ERROR_CAPACITY, "Decoded string does not fit in the arena");
+        return false;
+    }
+    
+    const char* bad = NULL;
+    ptrdiff_t len = fp_unescape(raw, out, &bad);
+    if (len < 0) {
+        fp_retreat_to(p, bad);
+        fp_set_error(p, FP_ERROR_INVALID_ESCAPE, "Invalid escape sequence");
+        return false;
+    }
+    
+    // Give back what decoding didn't use
+    arena->used -= raw.len - (size_t)len;
+    *result = (fp_view_t){.data = out, .len = (size_t)len};
+    return true;
+}
+
+// ============================================================================
+// CSV PARSING
+// ============================================================================
+
+// Row of any width for fp_parse_csv_row. Starts on caller storage (usually a
+// stack array) and moves into the arena when a row needs more fields; don't
+// reset the arena while the row is still in use.
+typedef struct {
+    fp_view_t* fields;
+    size_t count;
+    size_t capacity;
+    fp_arena_t* arena;      // NULL = fixed capacity
+} fp_csv_row_t;
+
+static inline bool fp_parse_csv_field(fp_parser_t* p, fp_view_t* field) {
+    fp_skip_ws(p);
+    
+    if (fp_at_end(p)) return false;
+    
+    if (fp_peek(p) == '"') {
+        return fp_parse_quoted_string(p, field);
+    } else {
+        const char* start = p->current;
+        fp_advance_to(p, fp_find_csv_delimiter(p->current, p->end));
+        
+        // Trim trailing whitespace
+        const char* end = p->current;
+        while (end > start && (end[-1] == ' ' || end[-1] == '\t')) {
+            end--;
+        }
+        
+        *field = (fp_view_t){.data = start, .len = end - start};
+        return true;
+    }
+}
+
+// Stack-allocated CSV parsing (no malloc); wider rows need fp_parse_csv_row
+#ifndef FP_CSV_MAX_FIELDS
+#define FP_CSV_MAX_FIELDS 64
+#endif
+
+static inline size_t fp_parse_csv_line(fp_parser_t* p, fp_view_t fields[FP_CSV_MAX_FIELDS]) {
+    size_t count = 0;
+    
+    while (!fp_at_end(p) && count < FP_CSV_MAX_FIELDS) {
+        if (!fp_parse_csv_field(p, &fields[count])) {
+            break;
+        }
+        count++;
+        
+        if (!fp_match_char(p, ',')) {
+            break;
+        }
+    }
+    
+    // Skip line ending
+    if (fp_match_char(p, '\r')) {
+        fp_match_char(p, '\n');
+    } else {
+        fp_match_char(p, '\n');
+    }
+    
+    return count;
+}
+
+static inline fp_csv_row_t fp_csv_row_init(fp_view_t* storage, size_t capacity, fp_arena_t* arena) {
+    return (fp_csv_row_t){.fields = storage, .count = 0, .capacity = capacity, .arena = arena};
+}
+
+// Declares a row backed by a FP_CSV_MAX_FIELDS stack array
+#define FP_CSV_ROW(name, arena) \
+    fp_view_t name##_storage[FP_CSV_MAX_FIELDS]; \
+    fp_csv_row_t name = fp_csv_row_init(name##_storage, FP_CSV_MAX_FIELDS, (arena))
+
+static inline bool fp_csv_row_grow(fp_csv_row_t* row) {
+    if (!row->arena) return false;
+    size_t capacity = row->capacity ? row->capacity * 2 : FP_CSV_MAX_FIELDS;
+    fp_view_t* fields = (fp_view_t*)fp_arena_alloc(row->arena, capacity * sizeof(fp_view_t));
+    if (!fields) return false;
+    if (row->count) memcpy(fields, row->fields, row->count * sizeof(fp_view_t));
+    row->fields = fields;
+    row->capacity = capacity;
+    return true;
+}
+
+// Like fp_parse_csv_line but without a field limit. The row keeps whatever
+// capacity it grew to, so reusing it across rows allocates only when a row is
+// wider than every row before it. If the arena runs out the rest of the record
+// is skipped, FP_ERROR_CAPACITY is set and the fields that fit are kept.
+static inline size_t fp_parse_csv_row(fp_parser_t* p, fp_csv_row_t* row) {
+    row->count = 0;
+    bool overflow = false;
+    fp_view_t field;
+    
+    while (!fp_at_end(p)) {
+        if (!fp_parse_csv_field(p, &field)) {
+            break;
+        }
+        if (!overflow && row->count == row->capacity && !fp_csv_row_grow(row)) {
+            fp_set_error(p, FP_ERROR_CAPACITY, "CSV row does not fit in the arena");
+            overflow = true;
+        }
+        if (!overflow) row->fields[row->count++] = field;
+        
+        if (!fp_match_char(p, ',')) {
+            break;
+        }
+    }
+    
+    // Skip line ending
+    if (fp_match_char(p, '\r')) {
+        fp_match_char(p, '\n');
+    } else {
+        fp_match_char(p, '\n');
+    }
+    
+    return row->count;
+}
+
+// Record boundaries with the field parser's quoting: a field is quoted only if
+// it opens with '"' (after blanks), a backslash escapes the next byte, and the
+// first unescaped '"' closes it. fp_parse_csv_line starts over with a new
+// field on anything but a delimiter after a closing quote, so that position
+// counts as a field start too. The state carries between calls so a record can
+// arrive in pieces.
+typedef enum {
+    FP_CSV_SCAN_FIELD = 0,  // at the start of a field
+    FP_CSV_SCAN_UNQUOTED,   // inside an unquoted field
+    FP_CSV_SCAN_QUOTED,     // inside quotes
+    FP_CSV_SCAN_ESCAPE      // inside quotes, right after a backslash
+} fp_csv_scan_state_t;
+
+// The '\n' that ends the record, or end (with *state updated) if none has
+// arrived yet. Lines without a quote take two memchr calls; anything else is
+// walked a byte at a time, which beats memchr hopping between short quoted runs.
+static inline const char* fp_csv_find_record_end(const char* s, const char* end,
+                                                 fp_csv_scan_state_t* state) {
+    fp_csv_scan_state_t st = *state;
+    if (s >= end) return end;
+    
+    if (st == FP_CSV_SCAN_FIELD || st == FP_CSV_SCAN_UNQUOTED) {
+        const char* newline = (const char*)memchr(s, '\n', (size_t)(end - s));
+        const char* stop = newline ? newline : end;
+        if (!memchr(s, '"', (size_t)(stop - s))) {
+            if (newline) {
+                *state = FP_CSV_SCAN_FIELD;
+                return newline;
+            }
+            // Partial line: only the field the data stops in matters
+            const char* t = end;
+            while (t > s && (t[-1] == ' ' || t[-1] == '\t')) t--;
+            if (t > s) *state = t[-1] == ',' ? FP_CSV_SCAN_FIELD : FP_CSV_SCAN_UNQUOTED;
+            return end;
+        }
+    }
+    
+    for (; s < end; s++) {
+        char c = *s;
+        switch (st) {
+            case FP_CSV_SCAN_FIELD:
+                if (c == '\n') {
+                    *state = FP_CSV_SCAN_FIELD;
+                    return s;
+                }
+                if (c == '"') st = FP_CSV_SCAN_QUOTED;
+                else if (c != ' ' && c != '\t' && c != ',') st = FP_CSV_SCAN_UNQUOTED;
+                break;
+            case FP_CSV_SCAN_UNQUOTED:
+                if (c == '\n') {
+                    *state = FP_CSV_SCAN_FIELD;
+                    return s;
+                }
+                if (c == ',') st = FP_CSV_SCAN_FIELD;
+                break;
+            case FP_CSV_SCAN_QUOTED:
+                if (c == '"') st = FP_CSV_SCAN_FIELD;
+                else if (c == '\\') st = FP_CSV_SCAN_ESCAPE;
+                break;
+            case FP_CSV_SCAN_ESCAPE:
+                st = FP_CSV_SCAN_QUOTED;
+                break;
+        }
+    }
+    *state = st;
+    return end;
+}
+
+// ============================================================================
+// CSV COLUMNAR BATCHES
+// ============================================================================
+// Parses up to capacity rows at a time into one array per column, typed by a
+// schema. Numbers are parsed straight from the input, so numeric columns never
+// build a view. Empty, missing and unparseable fields are null (bit set in
+// nulls); unparseable ones are also counted in errors. Extra fields past the
+// schema are skipped, blank lines produce no row.
+//
+// String columns hold one view per row rather than an offsets buffer over
+// copied bytes: a quoted field's bytes are already contiguous in the input, so
+// the view costs no copy. They stay valid only as long as the input does;
+// copy out (or build offsets yourself) if a batch has to outlive it.
+
+typedef enum {
+    FP_COLUMN_SKIP,
+    FP_COLUMN_INT64,
+    FP_COLUMN_DOUBLE,
+    FP_COLUMN_STRING        // views into the input (quotes stripped, escapes kept)
+} fp_column_type_t;
+
+typedef struct {
+    fp_column_type_t type;
+    int64_t* i64;
+    double* f64;
+    fp_view_t* str;
+    uint64_t* nulls;        // bit row set = null
+    size_t null_count;
+    size_t errors;
+} fp_column_t;
+
+typedef struct {
+    fp_column_t* columns;
+    size_t column_count;
+    size_t capacity;
+    size_t rows;
+    size_t errors;
+} fp_csv_batch_t;
+
+static inline void fp_csv_batch_free(fp_csv_batch_t* batch) {
+    if (batch->columns) {
+        for (size_t c = 0; c < batch->column_count; c++) {
+            free(batch->columns[c].i64);
+            free(batch->columns[c].f64);
+            free(batch->columns[c].str);
+            free(batch->columns[c].nulls);
+        }
+        free(batch->columns);
+    }
+    memset(batch, 0, sizeof(*batch));
+}
+
+static inline bool fp_csv_batch_init(fp_csv_batch_t* batch, const fp_column_type_t* schema,
+                                     size_t column_count, size_t capacity) {
+    memset(batch, 0, sizeof(*batch));
+    // fp_view_t is the widest per-row element, so this bounds every column array
+    if (capacity > SIZE_MAX / sizeof(fp_view_t)) return false;
+    batch->columns = (fp_column_t*)calloc(column_count ? column_count : 1, sizeof(fp_column_t));
+    if (!batch->columns) return false;
+    batch->column_count = column_count;
+    batch->capacity = capacity;
+    
+    size_t words = (capacity + 63) / 64;
+    for (size_t c = 0; c < column_count; c++) {
+        fp_column_t* col = &batch->columns[c];
+        col->type = schema[c];
+        bool ok = true;
+        switch (col->type) {
+            case FP_COLUMN_INT64: ok = (col->i64 = (int64_t*)malloc(capacity * sizeof(int64_t))) != NULL; break;
+            case FP_COLUMN_DOUBLE: ok = (col->f64 = (double*)malloc(capacity * sizeof(double))) != NULL; break;
+            case FP_COLUMN_STRING: ok = (col->str = (fp_view_t*)malloc(capacity * sizeof(fp_view_t))) != NULL; break;
+            case FP_COLUMN_SKIP: continue;
+        }
+        if (ok) ok = (col->nulls = (uint64_t*)calloc(words ? words : 1, sizeof(uint64_t))) != NULL;
+        if (!ok) {
+            fp_csv_batch_free(batch);
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline bool fp_csv_batch_is_null(const fp_csv_batch_t* batch, size_t column, size_t row) {
+    return (batch->columns[column].nulls[row >> 6] >> (row & 63)) & 1;
+}
+
+static inline void fp_csv_skip_blanks(fp_parser_t* p) {
+    const char* s = p->current;
+    while (s < p->end && (*s == ' ' || *s == '\t')) s++;
+    fp_advance_same_line(p, s);
+}
+
+static inline bool fp_csv_at_field_end(const fp_parser_t* p) {
+    char c = fp_peek(p);
+    return fp_at_end(p) || c == ',' || c == '\n' || c == '\r';
+}
+
+// Skips one field without a view; current is on a non-blank byte
+static inline void fp_csv_skip_field(fp_parser_t* p) {
+    if (fp_peek(p) == '"') {
+        fp_view_t ignored;
+        fp_parse_quoted_string(p, &ignored);
+    } else {
+        fp_advance_to(p, fp_find_csv_delimiter(p->current, p->end));
+    }
+}
+
+// Steps over the delimiter after a field (anything stray after a closing
+// quote is dropped); false at the end of the record
+static inline bool fp_csv_next_field(fp_parser_t* p) {
+    fp_csv_skip_blanks(p);
+    if (!fp_csv_at_field_end(p)) fp_advance_to(p, fp_find_csv_delimiter(p->current, p->end));
+    return fp_match_char(p, ',');
+}
+
+static inline void fp_csv_set_null(fp_column_t* col, size_t row) {
+    col->nulls[row >> 6] |= (uint64_t)1 << (row & 63);
+    col->null_count++;
+}
+
+// Parses the field at current into col; false if it did not fit the type
+static inline bool fp_csv_batch_field(fp_parser_t* p, fp_column_t* col, size_t row) {
+    if (col->type == FP_COLUMN_STRING || fp_peek(p) == '"') {
+        fp_view_t view;
+        if (!fp_parse_csv_field(p, &view)) return false;
+        if (col->type == FP_COLUMN_STRING) {
+            col->str[row] = view;
+            return true;
+        }
+        // Quoted number: parse the inside and require all of it to be used
+        fp_parser_t inner = fp_init(view.data, view.len);
+        bool ok = col->type == FP_COLUMN_INT64 ? fp_parse_int64(&inner, &col->i64[row])
+                                               : fp_parse_double(&inner, &col->f64[row]);
+        if (ok) fp_csv_skip_blanks(&inner);
+        return ok && fp_at_end(&inner);
+    }
+    
+    bool ok = col->type == FP_COLUMN_INT64 ? fp_parse_int64(p, &col->i64[row])
+                                           : fp_parse_double(p, &col->f64[row]);
+    if (ok) fp_csv_skip_blanks(p);
+    return ok && fp_csv_at_field_end(p);
+}
+
+// Parses up to batch->capacity rows from p into batch and returns the row
+// count (0 at end of input). The previous batch's contents are replaced.
+static inline size_t fp_parse_csv_batch(fp_parser_t* p, fp_csv_batch_t* batch) {
+    size_t words = (batch->capacity + 63) / 64;
+    batch->rows = 0;
+    batch->errors = 0;
+    for (size_t c = 0; c < batch->column_count; c++) {
+        fp_column_t* col = &batch->columns[c];
+        if (col->nulls) memset(col->nulls, 0, words * sizeof(uint64_t));
+        col->null_count = 0;
+        col->errors = 0;
+    }
+    
+    while (batch->rows < batch->capacity) {
+        fp_csv_skip_blanks(p);
+        if (fp_at_end(p)) break;
+        if (fp_match_char(p, '\r')) {
+            fp_match_char(p, '\n');
+            continue;
+        }
+        if (fp_match_char(p, '\n')) continue;
+        
+        size_t row = batch->rows++;
+        bool more = true;
+        
+        for (size_t c = 0; c < batch->column_count; c++) {
+            fp_column_t* col = &batch->columns[c];
+            if (more) fp_csv_skip_blanks(p);
+            
+            if (!more || fp_csv_at_field_end(p)) {
+                if (col->type != FP_COLUMN_SKIP) fp_csv_set_null(col, row);
+            } else if (col->type == FP_COLUMN_SKIP) {
+                fp_csv_skip_field(p);
+            } else if (!fp_csv_batch_field(p, col, row)) {
+                // Bad value: null it; fp_csv_next_field resyncs at the delimiter
+                p->error_code = FP_OK;
+                fp_csv_set_null(col, row);
+                col->errors++;
+                batch->errors++;
+            }
+            
+            if (more) more = fp_csv_next_field(p);
+        }
+        
+        // Fields past the schema
+        while (more) {
+            fp_csv_skip_blanks(p);
+            if (!fp_csv_at_field_end(p)) fp_csv_skip_field(p);
+            more = fp_csv_next_field(p);
+        }
+        
+        if (fp_match_char(p, '\r')) {
+            fp_match_char(p, '\n');
+        } else {
+            fp_match_char(p, '\n');
+        }
+    }
+    
+    return batch->rows;
+}
+
+// ============================================================================
+// JSON-LIKE PARSING
+// ============================================================================
+
+static inline bool fp_parse_json_string(fp_parser_t* p, fp_view_t* result) {
+    return fp_parse_quoted_string(p, result);
+}
+
+static inline bool fp_parse_json_number(fp_parser_t* p, double* result) {
+    return fp_parse_double(p, result);
+}
+
+static inline bool fp_skip_json_value(fp_parser_t* p);
+
+static inline bool fp_skip_json_object(fp_parser_t* p) {
+    if (!fp_match_char(p, '{')) return false;
+    
+    fp_skip_ws(p);
+    if (fp_match_char(p, '}')) return true; // Empty object
+    
+    do {
+        fp_skip_ws(p);
+        
+        // Skip key
+        fp_view_t key;
+        if (!fp_parse_json_string(p, &key)) return false;
+        
+        fp_skip_ws(p);
+        if (!fp_match_char(p, ':')) return false;
+        
+        fp_skip_ws(p);
+        if (!fp_skip_json_value(p)) return false;
+        
+        fp_skip_ws(p);
+    } while (fp_match_char(p, ','));
+    
+    return fp_match_char(p, '}');
+}
+
+static inline bool fp_skip_json_array(fp_parser_t* p) {
+    if (!fp_match_char(p, '[')) return false;
+    
+    fp_skip_ws(p);
+    if (fp_match_char(p, ']')) return true; // Empty array
+    
+    do {
+        fp_skip_ws(p);
+        if (!fp_skip_json_value(p)) return false;
+        fp_skip_ws(p);
+    } while (fp_match_char(p, ','));
+    
+    return fp_match_char(p, ']');
+}
+
+static inline bool fp_skip_json_value(fp_parser_t* p) {
+    fp_skip_ws(p);
+    
+    char c = fp_peek(p);
+    switch (c) {
+        case '"': {
+            fp_view_t str;
+            return fp_parse_json_string(p, &str);
+        }
+        case '{':
+            return fp_skip_json_object(p);
+        case '[':
+            return fp_skip_json_array(p);
+        case 't':
+            return fp_match_str(p, FP_VIEW("true"));
+        case 'f':
+            return fp_match_str(p, FP_VIEW("false"));
+        case 'n':
+            return fp_match_str(p, FP_VIEW("null"));
+        default:
+            if (c == '-' || isdigit(c)) {
+                double num;
+                return fp_parse_json_number(p, &num);
+            }
+            return false;
+    }
+}
+
+// ============================================================================
+// JSON STRUCTURAL INDEX
+// ============================================================================
+// Two-stage JSON: stage 1 classifies the whole buffer 64 bytes at a time and
+// records the offset of every structural character outside strings plus every
+// unescaped quote. Stage 2 skips values and finds keys by walking that index,
+// so the cost scales with the number of structurals, not bytes. Skipping is
+// structural only: brackets must balance, contents are not validated.
+//
+// That only holds with FP_LAZY_POSITION. Otherwise every jump goes through
+// fp_advance_to, which memchr-scans the skipped bytes to keep line/column
+// current; still faster than the byte walker, but O(bytes) again.
+
+typedef struct {
+    const char* data;
+    size_t len;
+    uint32_t* positions;    // ascending offsets; positions[count] == len
+    size_t count;
+    int error_code;
+} fp_json_index_t;
+
+// Bits of the block preceded by an odd run of backslashes. next_is_escaped
+// carries a trailing unmatched backslash into the next block.
+static inline uint64_t fp_json_escaped(uint64_t backslash, uint64_t* next_is_escaped) {
+    if (!backslash) {
+        uint64_t escaped = *next_is_escaped;
+        *next_is_escaped = 0;
+        return escaped;
+    }
+    const uint64_t odd_bits = 0xAAAAAAAAAAAAAAAAULL;
+    uint64_t potential_escape = backslash & ~*next_is_escaped;
+    uint64_t maybe_escaped = potential_escape << 1;
+    uint64_t escape_and_terminal = ((maybe_escaped | odd_bits) - potential_escape) ^ odd_bits;
+    uint64_t escaped = escape_and_terminal ^ (backslash | *next_is_escaped);
+    *next_is_escaped = (escape_and_terminal & backslash) >> 63;
+    return escaped;
+}
+
+// Bit i becomes the XOR of bits 0..i: set from an opening quote up to (not
+// including) its closing quote
+static inline uint64_t fp_prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+static inline void fp_json_index_free(fp_json_index_t* idx) {
+    free(idx->positions);
+    idx->positions = NULL;
+    idx->count = 0;
+}
+
+// Stage 1. Allocates the index (4 bytes per input byte worst case); release
+// it with fp_json_index_free. Fails on an unterminated string.
+static inline bool fp_json_index_build(fp_json_index_t* idx, const char* data, size_t len) {
+    idx->data = data;
+    idx->len = len;
+    idx->positions = NULL;
+    idx->count = 0;
+    idx->error_code = FP_OK;
+    
+    if (len >= UINT32_MAX) {
+        idx->error_code = FP_ERROR_OVERFLOW;
+        return false;
+    }
+    // Extraction writes up to 64 entries per block before trimming
+    idx->positions = (uint32_t*)malloc((len + 65) * sizeof(uint32_t));
+    if (!idx->positions) {
+        idx->error_code = FP_ERROR_CUSTOM;
+        return false;
+    }
+    
+    uint32_t* out = idx->positions;
+    uint64_t next_is_escaped = 0;
+    uint64_t in_string_carry = 0;
+    
+    for (size_t offset = 0; offset < len; offset += 64) {
+        const char* block = data + offset;
+        char tail[64];
+        uint64_t valid = ~0ULL;
+        if (len - offset < 64) {
+            // Pad the last block with spaces, which classify as nothing
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, len - offset);
+            block = tail;
+            valid = (1ULL << (len - offset)) - 1;
+        }
+        
+        uint64_t masks[3];
+        fp_kernels_load()->classify_json(block, masks);
+        
+        uint64_t escaped = fp_json_escaped(masks[1], &next_is_escaped);
+        uint64_t quotes = masks[0] & ~escaped;
+        uint64_t in_string = fp_prefix_xor(quotes) ^ in_string_carry;
+        in_string_carry = (uint64_t)((int64_t)in_string >> 63);
+        
+        uint64_t structurals = ((masks[2] & ~in_string) | quotes) & valid;
+        while (structurals) {
+            *out++ = (uint32_t)(offset + fp_ctz64(structurals));
+            structurals &= structurals - 1;
+        }
+    }
+    
+    idx->count = (size_t)(out - idx->positions);
+    idx->positions[idx->count] = (uint32_t)len;
+    
+    if (in_string_carry) {
+        idx->error_code = FP_ERROR_UNTERMINATED_STRING;
+        return false;
+    }
+    return true;
+}
+
+// First index slot whose offset is >= offset
+static inline size_t fp_json_index_lookup(const fp_json_index_t* idx, size_t offset) {
+    size_t lo = 0, hi = idx->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (idx->positions[mid] < offset) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Stage 2: skips the value at the parser position. Objects, arrays and
+// strings jump through the index; scalars use the byte parser. O(structurals)
+// with FP_LAZY_POSITION, plus a newline scan of the skipped bytes without it.
+static inline bool fp_skip_json_value_indexed(fp_parser_t* p, const fp_json_index_t* idx) {
+    fp_skip_ws(p);
+    char c = fp_peek(p);
+    if (c != '{' && c != '[' && c != '"') return fp_skip_json_value(p);
+    
+    size_t i = fp_json_index_lookup(idx, (size_t)(p->current - idx->data));
+    if (i >= idx->count || idx->data + idx->positions[i] != p->current) {
+        fp_set_error(p, FP_ERROR_CUSTOM, "Parser position is not in the JSON index");
+        return false;
+    }
+    
+    if (c == '"') {
+        if (i + 1 >= idx->count) {
+            fp_set_error(p, FP_ERROR_UNTERMINATED_STRING, "Expected closing quote");
+            return false;
+        }
+        fp_advance_to(p, idx->data + idx->positions[i + 1] + 1);
+        return true;
+    }
+    
+    size_t depth = 0;
+    for (; i < idx->count; i++) {
+        char s = idx->data[idx->positions[i]];
+        if (s == '{' || s == '[') {
+            depth++;
+        } else if (s == '}' || s == ']') {
+            if (--depth == 0) break;
+        }
+    }
+    if (i == idx->count) {
+        fp_set_error(p, FP_ERROR_EOF, c == '{' ? "Expected '}'" : "Expected ']'");
+        return false;
+    }
+    if (idx->data[idx->positions[i]] != (c == '{' ? '}' : ']')) {
+        fp_set_error(p, FP_ERROR_CUSTOM, "Mismatched bracket");
+        return false;
+    }
+    fp_advance_to(p, idx->data + idx->positions[i] + 1);
+    return true;
+}
+
+// Stage 2 key lookup in the object at the parser position. On success the
+// parser sits on the member's value; keys are compared raw (escapes as written).
+// Returns false without touching the parser if the key is absent.
+static inline bool fp_json_find_field_indexed(fp_parser_t* p, const fp_json_index_t* idx, fp_view_t key) {
+    fp_skip_ws(p);
+    if (fp_peek(p) != '{') {
+        fp_set_error(p, FP_ERROR_CUSTOM, "Expected '{'");
+        return false;
+    }
+    
+    size_t i = fp_json_index_lookup(idx, (size_t)(p->current - idx->data));
+    if (i >= idx->count || idx->data + idx->positions[i] != p->current) {
+        fp_set_error(p, FP_ERROR_CUSTOM, "Parser position is not in the JSON index");
+        return false;
+    }
+    
+    size_t depth = 0;
+    bool expect_key = false;
+    for (; i < idx->count; i++) {
+        uint32_t pos = idx->positions[i];
+        char s = idx->data[pos];
+        if (s == '{' || s == '[') {
+            depth++;
+            expect_key = (depth == 1);
+        } else if (s == '}' || s == ']') {
+            if (--depth == 0) return false;
+        } else if (s == ',') {
+            expect_key = (depth == 1);
+        } else if (s == '"') {
+            // Quotes come in pairs; the next entry closes this string
+            if (i + 1 >= idx->count) return false;
+            uint32_t close = idx->positions[++i];
+            if (depth == 1 && expect_key) {
+                expect_key = false;
+                size_t len = close - pos - 1;
+                if (len == key.len && memcmp(idx->data + pos + 1, key.data, len) == 0 &&
+                    i + 1 < idx->count && idx->data[idx->positions[i + 1]] == ':') {
+                    fp_advance_to(p, idx->data + idx->positions[i + 1] + 1);
+                    fp_skip_ws(p);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// ON-DEMAND JSON
+// ============================================================================
+// Reads fields straight out of the text without building a tree: look a value
+// up by path or iterate a container, then decode only what you touch with the
+// typed getters. Everything not asked for is skipped, through the structural
+// index when one is passed (NULL = byte-level skip). Keys are compared raw.
+
+typedef enum {
+    FP_JSON_INVALID = 0,
+    FP_JSON_NULL,
+    FP_JSON_BOOL,
+    FP_JSON_NUMBER,
+    FP_JSON_STRING,
+    FP_JSON_ARRAY,
+    FP_JSON_OBJECT
+} fp_json_type_t;
+
+// Type of the value at the parser position (skips leading whitespace)
+static inline fp_json_type_t fp_json_type(fp_parser_t* p) {
+    fp_skip_ws(p);
+    char c = fp_peek(p);
+    switch (c) {
+        case '{': return FP_JSON_OBJECT;
+        case '[': return FP_JSON_ARRAY;
+        case '"': return FP_JSON_STRING;
+        case 't':
+        case 'f': return FP_JSON_BOOL;
+        case 'n': return FP_JSON_NULL;
+        default: return (c == '-' || fp_is_digit(c)) ? FP_JSON_NUMBER : FP_JSON_INVALID;
+    }
+}
+
+static inline bool fp_json_skip(fp_parser_t* p, const fp_json_index_t* idx) {
+    bool ok = idx ? fp_skip_json_value_indexed(p, idx) : fp_skip_json_value(p);
+    if (!ok && !fp_has_error(p)) fp_set_error(p, FP_ERROR_CUSTOM, "Invalid JSON value");
+    return ok;
+}
+
+// Byte-level key lookup in the object at the parser position. On success the
+// parser sits on the member's value; if the key is absent the parser is left
+// where it was and no error is set.
+static inline bool fp_json_find_field(fp_parser_t* p, fp_view_t key) {
+    fp_position_t start = fp_save_position(p);
+    fp_skip_ws(p);
+    if (!fp_match_char(p, '{')) {
+        fp_set_error(p, FP_ERROR_CUSTOM, "Expected '{'");
+        return false;
+    }
+    
+    fp_skip_ws(p);
+    if (fp_peek(p) != '}') {
+        do {
+            fp_view_t name;
+            fp_skip_ws(p);
+            if (!fp_parse_json_string(p, &name)) return false;
+            fp_skip_ws(p);
+            if (!fp_match_char(p, ':')) {
+                fp_set_error(p, FP_ERROR_CUSTOM, "Expected ':'");
+                return false;
+            }
+            fp_skip_ws(p);
+            if (fp_view_equals(name, key)) return true;
+            if (!fp_json_skip(p, NULL)) return false;
+            fp_skip_ws(p);
+        } while (fp_match_char(p, ','));
+        
+        if (fp_peek(p) != '}') {
+            fp_set_error(p, FP_ERROR_CUSTOM, "Expected ',' or '}'");
+            return false;
+        }
+    }
+    
+    fp_restore_position(p, start);
+    return false;
+}
+
+// Follows keys[0..count) down nested objects. On success the parser sits on
+// the final value; a missing key leaves the parser where it started.
+static inline bool fp_json_find_path(fp_parser_t* p, const fp_json_index_t* idx,
+                                     const fp_view_t* keys, size_t count) {
+    fp_position_t start = fp_save_position(p);
+    for (size_t i = 0; i < count; i++) {
+        bool found = idx ? fp_json_find_field_indexed(p, idx, keys[i]) : fp_json_find_field(p, keys[i]);
+        if (!found) {
+            if (!fp_has_error(p)) fp_restore_position(p, start);
+            return false;
+        }
+    }
+    return true;
+}
+
+// fp_json_find(&p, FP_VIEW("user"), FP_VIEW("id"))
+#define fp_json_find(p, ...) \
+    fp_json_find_path((p), NULL, (const fp_view_t[]){__VA_ARGS__}, \
+                      sizeof((const fp_view_t[]){__VA_ARGS__}) / sizeof(fp_view_t))
+
+#define fp_json_find_indexed(p, idx, ...) \
+    fp_json_find_path((p), (idx), (const fp_view_t[]){__VA_ARGS__}, \
+                      sizeof((const fp_view_t[]){__VA_ARGS__}) / sizeof(fp_view_t))
+
+// Iterator over an object's members or an array's elements. Each next call
+// leaves the parser on a value; read it with a getter, descend into it, or
+// ignore it. The following next call skips the whole value from its start
+// either way.
+typedef struct {
+    fp_parser_t* p;
+    const fp_json_index_t* idx;
+    fp_position_t value;
+    char close;
+    bool started;
+    bool done;
+} fp_json_iter_t;
+
+static inline bool fp_json_iter_begin(fp_json_iter_t* it, fp_parser_t* p, const fp_json_index_t* idx,
+                                      char open, char close) {
+    it->p = p;
+    it->idx = idx;
+    it->close = close;
+    it->started = false;
+    it->done = true;
+    it->value = fp_save_position(p);
+    fp_skip_ws(p);
+    if (!fp_match_char(p, open)) {
+        fp_set_error(p, FP_ERROR_CUSTOM, open == '{' ? "Expected '{'" : "Expected '['");
+        return false;
+    }
+    it->done = false;
+    return true;
+}
+
+static inline bool fp_json_object_iter(fp_json_iter_t* it, fp_parser_t* p, const fp_json_index_t* idx) {
+    return fp_json_iter_begin(it, p, idx, '{', '}');
+}
+
+static inline bool fp_json_array_iter(fp_json_iter_t* it, fp_parser_t* p, const fp_json_index_t* idx) {
+    return fp_json_iter_begin(it, p, idx, '[', ']');
+}
+
+// Finishes the previous value and steps to the next one; false at the end
+static inline bool fp_json_iter_advance(fp_json_iter_t* it) {
+    fp_parser_t* p = it->p;
+    if (it->done) return false;
+    
+    if (it->started) {
+        fp_restore_position(p, it->value);
+        if (!fp_json_skip(p, it->idx)) {
+            it->done = true;
+            return false;
+        }
+        fp_skip_ws(p);
+        if (fp_match_char(p, ',')) return true;
+    } else {
+        it->started = true;
+        fp_skip_ws(p);
+        if (fp_peek(p) != it->close) return true;
+    }
+    
+    it->done = true;
+    if (fp_match_char(p, it->close)) return false;
+    fp_set_error(p, FP_ERROR_CUSTOM, it->close == '}' ? "Expected ',' or '}'" : "Expected ',' or ']'");
+    return false;
+}
+
+// Next member; the parser is left on its value. False at '}' or on error
+// (check fp_has_error).
+static inline bool fp_json_object_next(fp_json_iter_t* it, fp_view_t* key) {
+    fp_parser_t* p = it->p;
+    if (!fp_json_iter_advance(it)) return false;
+    fp_skip_ws(p);
+    if (!fp_parse_json_string(p, key)) {
+        it->done = true;
+        return false;
+    }
+    fp_skip_ws(p);
+    if (!fp_match_char(p, ':')) {
+        fp_set_error(p, FP_ERROR_CUSTOM, "Expected ':'");
+        it->done = true;
+        return false;
+    }
+    fp_skip_ws(p);
+    it->value = fp_save_position(p);
+    return true;
+}
+
+// Next element; the parser is left on it. False at ']' or on error.
+static inline bool fp_json_array_next(fp_json_iter_t* it) {
+    if (!fp_json_iter_advance(it)) return false;
+    fp_skip_ws(it->p);
+    it->value = fp_save_position(it->p);
+    return true;
+}
+
+// Typed getters: each reads the value at the parser position and leaves the
+// parser after it. A value of another type sets an error and is not consumed.
+
+// Raw view with arena == NULL, otherwise decoded (zero-copy without escapes)
+static inline bool fp_json_get_string(fp_parser_t* p, fp_arena_t* arena, fp_view_t* out) {
+    if (fp_json_type(p) != FP_JSON_STRING) {
+        fp_set_error(p, FP_ERROR_CUSTOM, "Expected string");
+        return false;
+    }
+    return arena ? fp_parse_string_decoded(p, arena, out) : fp_parse_json_string(p, out);
+}
+
+static inline bool fp_json_get_double(fp_parser_t* p, double* out) {
+    if (fp_json_type(p) != FP_JSON_NUMBER) {
+        fp_set_error(p, FP_ERROR_CUSTOM, "Expected number");
+        return false;
+    }
+    return fp_parse_json_number(p, out);
+}
+
+// Integral numbers only: a fraction or exponent is FP_ERROR_INVALID_NUMBER
+static inline bool fp_json_get_int64(fp_parser_t* p, int64_t* out) {
+    if (fp_json_type(p) != FP_JSON_NUMBER) {
+        fp_set_error(p, FP_ERROR_CUSTOM, "Expected number");
+        return false;
+    }
+    fp_position_t start = fp_save_position(p);
+    if (!fp_parse_int64(p, out)) return false;
+    char c = fp_peek(p);
+    if (c == '.' || c == 'e' || c == 'E') {
+        fp_restore_position(p, start);
+        fp_set_error(p, FP_ERROR_INVALID_NUMBER, "Expected integer");
+        return false;
+    }
+    return true;
+}
+
+static inline bool fp_json_get_bool(fp_parser_t* p, bool* out) {
+    if (fp_json_type(p) == FP_JSON_BOOL) {
+        if (fp_match_str(p, FP_VIEW("true"))) {
+            *out = true;
+            return true;
+        }
+        if (fp_match_str(p, FP_VIEW("false"))) {
+            *out = false;
+            return true;
+        }
+    }
+    fp_set_error(p, FP_ERROR_CUSTOM, "Expected boolean");
+    return false;
+}
+
+// Consumes null and returns true; anything else is left alone (no error)
+static inline bool fp_json_get_null(fp_parser_t* p) {
+    return fp_json_type(p) == FP_JSON_NULL && fp_match_str(p, FP_VIEW("null"));
+}
+
+// ============================================================================
+// KEY SETS
+// ============================================================================
+// Minimal perfect hash over a fixed set of names (hash and displace): keys are
+// hashed into buckets, and each bucket gets a displacement that sends its keys
+// to free slots. A lookup is one hash, one table read and one memcmp, however
+// many keys there are. C builds the tables once at startup:
+//
+//     FP_KEYSET(fields, FP_VIEW("id"), FP_VIEW("name"), FP_VIEW("email"));
+//     FP_KEYSET_BUILD(fields);                  // once, before lookups
+//     int which = fp_keyset_find(&fields, key); // 0..2, or -1
+//
+// C++14 builds them at compile time with fp::make_keyset (end of this file).
+
+#ifndef FP_KEYSET_MAX_KEYS
+#define FP_KEYSET_MAX_KEYS 256
+#endif
+
+#define FP_KEYSET_BUCKETS(n) ((n) / 2 + 1)
+#define FP_KEYSET_SLOTS(n) (2 * (n) + 1)
+#define FP_KEYSET_COUNT(keys) (sizeof(keys) / sizeof((keys)[0]))
+
+typedef struct {
+    const fp_view_t* keys;
+    uint32_t count;
+    uint32_t buckets;
+    uint32_t slot_count;
+    uint64_t seed;
+    const uint16_t* displace;   // per bucket
+    const int16_t* slots;       // key index per slot, -1 = empty
+} fp_keyset_t;
+
+FP_CONSTEXPR static inline uint64_t fp_keyset_mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+FP_CONSTEXPR static inline uint32_t fp_keyset_mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+// Maps a 32-bit hash onto [0, n) without a division
+FP_CONSTEXPR static inline uint32_t fp_keyset_range(uint32_t h, uint32_t n) {
+    return (uint32_t)(((uint64_t)h * n) >> 32);
+}
+
+// Little-endian words assembled byte by byte, so it also runs in constexpr
+FP_CONSTEXPR static inline uint64_t fp_keyset_hash_bytes(const char* s, size_t len, uint64_t seed) {
+    uint64_t h = seed ^ ((uint64_t)len * 0x9E3779B97F4A7C15ULL);
+    for (size_t i = 0; i < len; i += 8) {
+        uint64_t w = 0;
+        for (size_t b = 0; b < 8 && i + b < len; b++) {
+            w |= (uint64_t)(unsigned char)s[i + b] << (8 * b);
+        }
+        h = fp_keyset_mix64(h ^ w);
+    }
+    return fp_keyset_mix64(h);
+}
+
+// Same hash for lookups, with plain word loads where the byte order allows
+static inline uint64_t fp_keyset_hash(const char* s, size_t len, uint64_t seed) {
+#ifdef FP_LITTLE_ENDIAN
+    uint64_t h = seed ^ ((uint64_t)len * 0x9E3779B97F4A7C15ULL);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) h = fp_keyset_mix64(h ^ fp_load64(s + i));
+    if (i < len) {
+        uint64_t w = 0;
+        memcpy(&w, s + i, len - i);
+        h = fp_keyset_mix64(h ^ w);
+    }
+    return fp_keyset_mix64(h);
+#else
+    return fp_keyset_hash_bytes(s, len, seed);
+#endif
+}
+
+FP_CONSTEXPR static inline uint32_t fp_keyset_slot(uint64_t h, uint32_t displace, uint32_t slot_count) {
+    return fp_keyset_range(fp_keyset_mix32((uint32_t)h ^ (displace * 0x9E3779B9U)), slot_count);
+}
+
+// Searches a seed and per-bucket displacements that place every key in its
+// own slot. displace needs FP_KEYSET_BUCKETS(count) entries, slots
+// FP_KEYSET_SLOTS(count). Fails for duplicate keys or more than
+// FP_KEYSET_MAX_KEYS.
+FP_CONSTEXPR static inline bool fp_keyset_build_tables(const fp_view_t* keys, size_t count, uint64_t* seed_out,
+                                                       uint16_t* displace, int16_t* slots) {
+    if (count > FP_KEYSET_MAX_KEYS) return false;
+    uint32_t buckets = (uint32_t)FP_KEYSET_BUCKETS(count);
+    uint32_t slot_count = (uint32_t)FP_KEYSET_SLOTS(count);
+    
+    uint64_t hashes[FP_KEYSET_MAX_KEYS] = {0};
+    uint32_t bucket_of[FP_KEYSET_MAX_KEYS] = {0};
+    uint32_t members[FP_KEYSET_MAX_KEYS] = {0};         // key indices grouped by bucket
+    uint32_t bucket_start[FP_KEYSET_BUCKETS(FP_KEYSET_MAX_KEYS) + 1] = {0};
+    uint32_t order[FP_KEYSET_BUCKETS(FP_KEYSET_MAX_KEYS)] = {0};
+    uint32_t placed[FP_KEYSET_MAX_KEYS] = {0};
+    
+    for (uint64_t attempt = 1; attempt <= 64; attempt++) {
+        uint64_t seed = fp_keyset_mix64(attempt);
+        
+        for (uint32_t b = 0; b <= buckets; b++) bucket_start[b] = 0;
+        for (size_t i = 0; i < count; i++) {
+            hashes[i] = fp_keyset_hash_bytes(keys[i].data, keys[i].len, seed);
+            bucket_of[i] = fp_keyset_range((uint32_t)(hashes[i] >> 32), buckets);
+            bucket_start[bucket_of[i] + 1]++;
+        }
+        
+        // Buckets largest first: the crowded ones are placed while slots are free
+        uint32_t ordered = 0;
+        for (uint32_t size = (uint32_t)count; size > 0; size--) {
+            for (uint32_t b = 0; b < buckets; b++) {
+                if (bucket_start[b + 1] == size) order[ordered++] = b;
+            }
+        }
+        for (uint32_t b = 0; b < buckets; b++) bucket_start[b + 1] += bucket_start[b];
+        for (size_t i = 0; i < count; i++) {
+            uint32_t b = bucket_of[i];
+            // bucket_start[b] is advanced while filling and walked back below
+            members[bucket_start[b]++] = (uint32_t)i;
+        }
+        for (uint32_t b = buckets; b > 0; b--) bucket_start[b] = bucket_start[b - 1];
+        bucket_start[0] = 0;
+        
+        for (uint32_t s = 0; s < slot_count; s++) slots[s] = -1;
+        for (uint32_t b = 0; b < buckets; b++) displace[b] = 0;
+        
+        bool ok = true;
+        for (uint32_t o = 0; o < ordered && ok; o++) {
+            uint32_t b = order[o];
+            uint32_t first = bucket_start[b], last = bucket_start[b + 1];
+            ok = false;
+            for (uint32_t d = 0; d < 65536 && !ok; d++) {
+                uint32_t n = 0;
+                for (uint32_t m = first; m < last; m++) {
+                    uint32_t s = fp_keyset_slot(hashes[members[m]], d, slot_count);
+                    if (slots[s] >= 0) break;
+                    slots[s] = (int16_t)members[m];
+                    placed[n++] = s;
+                }
+                if (n == last - first) {
+                    displace[b] = (uint16_t)d;
+                    ok = true;
+                } else {
+                    while (n > 0) slots[placed[--n]] = -1;
+                }
+            }
+        }
+        if (ok) {
+            *seed_out = seed;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool fp_keyset_build(fp_keyset_t* set, const fp_view_t* keys, size_t count,
+                                   uint16_t* displace, int16_t* slots) {
+    set->keys = keys;
+    set->count = 0;
+    set->buckets = (uint32_t)FP_KEYSET_BUCKETS(count);
+    set->slot_count = (uint32_t)FP_KEYSET_SLOTS(count);
+    set->displace = displace;
+    set->slots = slots;
+    if (!fp_keyset_build_tables(keys, count, &set->seed, displace, slots)) return false;
+    set->count = (uint32_t)count;
+    return true;
+}
+
+// Defines keys plus table storage for a set; FP_KEYSET_BUILD fills it in
+#define FP_KEYSET(name, ...) \
+    static const fp_view_t name##_keys[] = {__VA_ARGS__}; \
+    static uint16_t name##_displace[FP_KEYSET_BUCKETS(FP_KEYSET_COUNT(name##_keys))]; \
+    static int16_t name##_slots[FP_KEYSET_SLOTS(FP_KEYSET_COUNT(name##_keys))]; \
+    static fp_keyset_t name
+
+#define FP_KEYSET_BUILD(name) \
+    fp_keyset_build(&name, name##_keys, FP_KEYSET_COUNT(name##_keys), name##_displace, name##_slots)
+
+// Index of key in the set, or -1 (also for a set that failed to build)
+static inline int fp_keyset_find(const fp_keyset_t* set, fp_view_t key) {
+    if (set->count == 0) return -1;
+    uint64_t h = fp_keyset_hash(key.data, key.len, set->seed);
+    uint32_t b = fp_keyset_range((uint32_t)(h >> 32), set->buckets);
+    int i = set->slots[fp_keyset_slot(h, set->displace[b], set->slot_count)];
+    if (i < 0) return -1;
+    fp_view_t k = set->keys[i];
+    return (k.len == key.len && memcmp(k.data, key.data, key.len) == 0) ? i : -1;
+}
+
+// Object member iteration that also resolves the key: *which is its index in
+// set, or -1 for names outside it
+static inline bool fp_json_object_next_key(fp_json_iter_t* it, const fp_keyset_t* set, int* which) {
+    fp_view_t key;
+    if (!fp_json_object_next(it, &key)) return false;
+    *which = fp_keyset_find(set, key);
+    return true;
+}
+
+// Maps a CSV header row onto a key set: column_of[k] is the column holding
+// key k, or -1 if the header lacks it. Returns how many keys were found; a
+// repeated name keeps its first column.
+static inline size_t fp_csv_map_header(const fp_view_t* fields, size_t count, const fp_keyset_t* set,
+                                       int* column_of) {
+    size_t found = 0;
+    for (uint32_t k = 0; k < set->count; k++) column_of[k] = -1;
+    for (size_t c = 0; c < count; c++) {
+        int k = fp_keyset_find(set, fields[c]);
+        if (k >= 0 && column_of[k] < 0) {
+            column_of[k] = (int)c;
+            found++;
+        }
+    }
+    return found;
+}
+
+// ============================================================================
+// STREAMING INPUT
+// ============================================================================
+// Feeds a file of any size through a fixed buffer, one complete record at a
+// time. Records are lines (NDJSON, logs) or CSV rows, where newlines inside
+// quoted fields do not end the row. Only the unfinished tail is carried over
+// between chunks, so a token is never split; the buffer grows only if a
+// single record is larger than it.
+
+#ifndef FP_STREAM_CHUNK_SIZE
+#define FP_STREAM_CHUNK_SIZE (1 << 20)
+#endif
+
+// Reads up to capacity bytes into buffer; returns 0 at end of input
+typedef size_t (*fp_read_fn_t)(void* user, char* buffer, size_t capacity);
+
+typedef enum {
+    FP_STREAM_LINES = 0,    // records end at '\n'
+    FP_STREAM_CSV           // records end at '\n' outside quoted fields
+} fp_stream_mode_t;
+
+typedef struct {
+    char* buffer;
+    size_t capacity;
+    size_t len;             // bytes held
+    size_t pos;             // start of the first undelivered record
+    size_t scan;            // boundary search resumes here
+    fp_csv_scan_state_t csv_state; // CSV quote state at scan
+    bool eof;
+    fp_stream_mode_t mode;
+    fp_read_fn_t read;      // NULL: input is pushed with fp_stream_feed
+    void* user;
+    size_t line;            // line number the next record starts on
+    int error_code;
+} fp_stream_t;
+
+// fread-based reader; pass the FILE* as user
+static inline size_t fp_stream_read_file(void* user, char* buffer, size_t capacity) {
+    return fread(buffer, 1, capacity, (FILE*)user);
+}
+
+static inline bool fp_stream_init(fp_stream_t* s, fp_stream_mode_t mode, size_t capacity,
+                                  fp_read_fn_t read, void* user) {
+    memset(s, 0, sizeof(*s));
+    s->capacity = capacity ? capacity : FP_STREAM_CHUNK_SIZE;
+    s->buffer = (char*)malloc(s->capacity);
+    s->mode = mode;
+    s->read = read;
+    s->user = user;
+    s->line = 1;
+    if (!s->buffer) {
+        s->error_code = FP_ERROR_CUSTOM;
+        return false;
+    }
+    return true;
+}
+
+static inline void fp_stream_free(fp_stream_t* s) {
+    free(s->buffer);
+    s->buffer = NULL;
+    s->capacity = s->len = s->pos = s->scan = 0;
+}
+
+// Drops delivered records and makes room for at least extra more bytes
+static inline bool fp_stream_reserve(fp_stream_t* s, size_t extra) {
+    if (s->pos > 0) {
+        memmove(s->buffer, s->buffer + s->pos, s->len - s->pos);
+        s->len -= s->pos;
+        s->scan -= s->pos;
+        s->pos = 0;
+    }
+    if (s->capacity - s->len >= extra) return true;
+    
+    size_t capacity = s->capacity;
+    while (capacity - s->len < extra) capacity *= 2;
+    char* buffer = (char*)realloc(s->buffer, capacity);
+    if (!buffer) {
+        s->error_code = FP_ERROR_CUSTOM;
+        return false;
+    }
+    s->buffer = buffer;
+    s->capacity = capacity;
+    return true;
+}
+
+// Push mode: append input. Call fp_stream_finish after the last chunk.
+static inline bool fp_stream_feed(fp_stream_t* s, const void* data, size_t len) {
+    if (!fp_stream_reserve(s, len)) return false;
+    memcpy(s->buffer + s->len, data, len);
+    s->len += len;
+    return true;
+}
+
+static inline void fp_stream_finish(fp_stream_t* s) {
+    s->eof = true;
+}
+
+// True once the input has ended and every record was delivered
+static inline bool fp_stream_done(const fp_stream_t* s) {
+    return s->eof && s->pos >= s->len;
+}
+
+// Finds the end of the record starting at pos, resuming where the last
+// search stopped so no byte is scanned twice
+static inline bool fp_stream_find_record(fp_stream_t* s, size_t* record_end) {
+    const char* base = s->buffer;
+    const char* end = base + s->len;
+    if (s->scan >= s->len) return false;
+    
+    const char* from = base + s->scan;
+    const char* newline;
+    if (s->mode == FP_STREAM_CSV) {
+        newline = fp_csv_find_record_end(from, end, &s->csv_state);
+    } else {
+        newline = (const char*)memchr(from, '\n', (size_t)(end - from));
+        if (!newline) newline = end;
+    }
+    
+    if (newline >= end) {
+        s->scan = s->len;
+        return false;
+    }
+    s->scan = (size_t)(newline - base) + 1;
+    *record_end = s->scan;
+    return true;
+}
+
+static inline void fp_stream_deliver(fp_stream_t* s, size_t record_end, fp_parser_t* record) {
+    const char* start = s->buffer + s->pos;
+    size_t len = record_end - s->pos;
+    *record = fp_init(start, len);
+    record->line = s->line;
+    s->line += fp_count_newlines(start, start + len);
+    s->pos = record_end;
+}
+
+// Next complete record, terminator included, as a parser whose line numbers
+// count from the start of the stream. The record stays valid until the next
+// call. Returns false at the end of input, or in push mode when no complete
+// record is buffered yet (check fp_stream_done).
+static inline bool fp_stream_next(fp_stream_t* s, fp_parser_t* record) {
+    for (;;) {
+        size_t record_end;
+        if (fp_stream_find_record(s, &record_end)) {
+            fp_stream_deliver(s, record_end, record);
+            return true;
+        }
+        
+        if (s->eof) {
+            // Last record without a trailing newline
+            if (s->pos < s->len) {
+                s->scan = s->len;
+                fp_stream_deliver(s, s->len, record);
+                return true;
+            }
+            return false;
+        }
+        
+        if (!s->read) return false;
+        
+        // Keep the partial record, then read the next chunk behind it
+        size_t chunk = s->capacity / 2 ? s->capacity / 2 : 1;
+        if (!fp_stream_reserve(s, chunk)) return false;
+        size_t got = s->read(s->user, s->buffer + s->len, s->capacity - s->len);
+        if (got == 0) s->eof = true;
+        s->len += got;
+    }
+}
+
+// ============================================================================
+// MEMORY-MAPPED FILE INPUT
+// ============================================================================
+// The parser points straight into the mapping, so views stay valid until
+// fp_close_mapped. At least FP_PADDING zero bytes follow the last byte of
+// the file and may be read (never written) by code that loads whole vectors.
+
+#ifndef FP_NO_FILE_IO
+
+#define FP_PADDING 64
+
+typedef enum {
+    FP_MAP_SEQUENTIAL = 1 << 0,     // read-ahead hint for front-to-back parsing
+    FP_MAP_RANDOM = 1 << 1,         // no read-ahead (index lookups)
+    FP_MAP_HUGE_PAGES = 1 << 2,     // ask for transparent huge pages where supported
+    FP_MAP_POPULATE = 1 << 3        // fault everything in up front
+} fp_map_flags_t;
+
+typedef struct {
+    fp_parser_t parser;
+    const char* data;
+    size_t size;            // file size
+    void* base;             // start of the mapping or copy
+    size_t mapped_size;
+    bool copied;            // padding could not be mapped; data is a heap copy
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} fp_mapped_t;
+
+static const char fp_empty_padded[FP_PADDING] = {0};
+
+static inline fp_mapped_t fp_mapped_error(const char* path, const char* what) {
+    fp_mapped_t m;
+    memset(&m, 0, sizeof(m));
+    m.parser = fp_init(fp_empty_padded, 0);
+#ifdef FP_COMPACT_ERRORS
+    // No room for the path; what is a literal and errno rides along as the arg
+    (void)path;
+    fp_set_error_arg(&m.parser, FP_ERROR_IO, what, errno);
+#else
+    char msg[sizeof(m.parser.error_msg) - 32];
+    snprintf(msg, sizeof(msg), "%s '%s': %s", what, path, strerror(errno));
+    fp_set_error(&m.parser, FP_ERROR_IO, msg);
+#endif
+    return m;
+}
+
+static inline fp_mapped_t fp_mapped_finish(fp_mapped_t m) {
+    m.parser = fp_init(m.data, m.size);
+    return m;
+}
+
+// Maps path read-only. On failure the parser is empty and carries FP_ERROR_IO.
+static inline fp_mapped_t fp_open_mapped_ex(const char* path, int flags) {
+    fp_mapped_t m;
+    memset(&m, 0, sizeof(m));
+    (void)flags;
+    
+#ifdef _WIN32
+    m.file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                         (flags & FP_MAP_RANDOM) ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (m.file == INVALID_HANDLE_VALUE) return fp_mapped_error(path, "Cannot open");
+    
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(m.file, &file_size)) {
+        CloseHandle(m.file);
+        return fp_mapped_error(path, "Cannot stat");
+    }
+    m.size = (size_t)file_size.QuadPart;
+    if (m.size == 0) {
+        CloseHandle(m.file);
+        m.file = NULL;
+        m.data = fp_empty_padded;
+        return fp_mapped_finish(m);
+    }
+    
+    m.mapping = CreateFileMappingA(m.file, NULL, PAGE_READONLY, 0, 0, NULL);
+    m.base = m.mapping ? MapViewOfFile(m.mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!m.base) {
+        if (m.mapping) CloseHandle(m.mapping);
+        CloseHandle(m.file);
+        return fp_mapped_error(path, "Cannot map");
+    }
+    m.mapped_size = m.size;
+    
+    // The tail of the last page reads as zeros; copy if it is too short
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t slack = (info.dwPageSize - m.size % info.dwPageSize) % info.dwPageSize;
+    if (slack < FP_PADDING) {
+        char* copy = (char*)malloc(m.size + FP_PADDING);
+        if (copy) {
+            memcpy(copy, m.base, m.size);
+            memset(copy + m.size, 0, FP_PADDING);
+        }
+        UnmapViewOfFile(m.base);
+        CloseHandle(m.mapping);
+        CloseHandle(m.file);
+        m.mapping = m.file = NULL;
+        if (!copy) return fp_mapped_error(path, "Cannot allocate copy of");
+        m.base = copy;
+        m.copied = true;
+    }
+    m.data = (const char*)m.base;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return fp_mapped_error(path, "Cannot open");
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return fp_mapped_error(path, "Cannot stat");
+    }
+    m.size = (size_t)st.st_size;
+    if (m.size == 0) {
+        close(fd);
+        m.data = fp_empty_padded;
+        return fp_mapped_finish(m);
+    }
+    
+    // The rest of the file's last page reads as zeros. When that is shorter
+    // than the padding, reserve zero pages for it and map the file over them.
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t slack = (page - m.size % page) % page;
+    int map_flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (flags & FP_MAP_POPULATE) map_flags |= MAP_POPULATE;
+#endif
+    
+    if (slack >= FP_PADDING) {
+        m.mapped_size = m.size;
+        m.base = mmap(NULL, m.size, PROT_READ, map_flags, fd, 0);
+    } else {
+#if defined(MAP_ANONYMOUS) || defined(MAP_ANON)
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+        m.mapped_size = m.size + page;
+        m.base = mmap(NULL, m.mapped_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (m.base != MAP_FAILED &&
+            mmap(m.base, m.size, PROT_READ, map_flags | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            int saved = errno;
+            munmap(m.base, m.mapped_size);
+            errno = saved;
+            m.base = MAP_FAILED;
+        }
+#else
+        // No anonymous mappings in this build: read into a padded copy
+        char* copy = (char*)malloc(m.size + FP_PADDING);
+        size_t got = 0;
+        while (copy && got < m.size) {
+            ssize_t n = read(fd, copy + got, m.size - got);
+            if (n <= 0) {
+                free(copy);
+                copy = NULL;
+                break;
+            }
+            got += (size_t)n;
+        }
+        if (!copy) {
+            close(fd);
+            return fp_mapped_error(path, "Cannot read");
+        }
+        memset(copy + m.size, 0, FP_PADDING);
+        close(fd);
+        m.base = copy;
+        m.copied = true;
+        m.data = copy;
+        return fp_mapped_finish(m);
+#endif
+    }
+    if (m.base == MAP_FAILED) {
+        m.base = NULL;
+        close(fd);
+        return fp_mapped_error(path, "Cannot map");
+    }
+    close(fd);
+    
+#ifdef MADV_SEQUENTIAL
+    if (flags & FP_MAP_SEQUENTIAL) madvise(m.base, m.size, MADV_SEQUENTIAL);
+    if (flags & FP_MAP_RANDOM) madvise(m.base, m.size, MADV_RANDOM);
+#elif defined(POSIX_MADV_SEQUENTIAL)
+    if (flags & FP_MAP_SEQUENTIAL) posix_madvise(m.base, m.size, POSIX_MADV_SEQUENTIAL);
+    if (flags & FP_MAP_RANDOM) posix_madvise(m.base, m.size, POSIX_MADV_RANDOM);
+#endif
+#ifdef MADV_HUGEPAGE
+    if (flags & FP_MAP_HUGE_PAGES) madvise(m.base, m.size, MADV_HUGEPAGE);
+#endif
+    m.data = (const char*)m.base;
+#endif
+    
+    return fp_mapped_finish(m);
+}
+
+static inline fp_mapped_t fp_open_mapped(const char* path) {
+    return fp_open_mapped_ex(path, FP_MAP_SEQUENTIAL);
+}
+
+static inline bool fp_mapped_ok(const fp_mapped_t* m) {
+    return m->parser.error_code != FP_ERROR_IO;
+}
+
+static inline fp_view_t fp_mapped_view(const fp_mapped_t* m) {
+    return (fp_view_t){.data = m->data, .len = m->size};
+}
+
+static inline void fp_close_mapped(fp_mapped_t* m) {
+    if (m->copied) {
+        free(m->base);
+    } else if (m->base) {
+#ifdef _WIN32
+        UnmapViewOfFile(m->base);
+        if (m->mapping) CloseHandle(m->mapping);
+        if (m->file) CloseHandle(m->file);
+#else
+        munmap(m->base, m->mapped_size);
+#endif
+    }
+    memset(m, 0, sizeof(*m));
+    m->parser = fp_init(fp_empty_padded, 0);
+}
+
+#endif // FP_NO_FILE_IO
+
+// ============================================================================
+// PARALLEL CSV
+// ============================================================================
+// Splits a buffer into fixed-size chunks and parses them on worker threads:
+//   1. per chunk (parallel): run fp_csv_find_record_end as if the chunk started
+//      outside quotes and as if it started inside, keeping each guess's first
+//      record end and final state (the two usually meet at a record end early,
+//      after which one scan serves both)
+//   2. sequentially: carry the real state across chunks to pick each chunk's
+//      first record start, rescanning the rare chunk neither guess fits
+//   3. per chunk (parallel): parse its records with fp_parse_csv_line
+// Boundaries follow the field parser's quoting (backslash escapes).
+
+#ifndef FP_NO_THREADS
+
+#ifndef FP_PARALLEL_CHUNK_SIZE
+#define FP_PARALLEL_CHUNK_SIZE (4 << 20)
+#endif
+
+typedef void (*fp_parallel_fn_t)(void* ctx, size_t index, int thread);
+
+typedef struct {
+    fp_parallel_fn_t fn;
+    void* ctx;
+    size_t count;
+    volatile size_t next;
+} fp_parallel_job_t;
+
+typedef struct {
+    fp_parallel_job_t* job;
+    int thread;
+} fp_parallel_worker_t;
+
+static inline size_t fp_atomic_fetch_inc(volatile size_t* value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (size_t)InterlockedExchangeAdd64((volatile LONG64*)value, 1);
+#else
+    return __atomic_fetch_add(value, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline size_t fp_atomic_load_acquire(volatile size_t* value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    size_t result = *value;
+    _ReadWriteBarrier();
+    return result;
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void fp_atomic_store_release(volatile size_t* value, size_t desired) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    _ReadWriteBarrier();
+    *value = desired;
+#else
+    __atomic_store_n(value, desired, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline int fp_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+static inline void fp_parallel_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static inline void fp_parallel_run(fp_parallel_worker_t* worker) {
+    fp_parallel_job_t* job = worker->job;
+    for (;;) {
+        size_t index = fp_atomic_fetch_inc(&job->next);
+        if (index >= job->count) break;
+        job->fn(job->ctx, index, worker->thread);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI fp_parallel_thread(LPVOID arg) {
+    fp_parallel_run((fp_parallel_worker_t*)arg);
+    return 0;
+}
+#else
+static void* fp_parallel_thread(void* arg) {
+    fp_parallel_run((fp_parallel_worker_t*)arg);
+    return NULL;
+}
+#endif
+
+// Calls fn(ctx, i, thread) for every i in [0, count) on up to threads workers
+// (0 = one per CPU); indices are handed out dynamically. The calling thread
+// works too, as thread 0.
+static inline void fp_parallel_for(size_t count, int threads, fp_parallel_fn_t fn, void* ctx) {
+    if (threads <= 0) threads = fp_cpu_count();
+    if ((size_t)threads > count) threads = count ? (int)count : 1;
+    
+    fp_parallel_job_t job = {fn, ctx, count, 0};
+    fp_parallel_worker_t* workers = (fp_parallel_worker_t*)malloc((size_t)threads * sizeof(fp_parallel_worker_t));
+#ifdef _WIN32
+    HANDLE* handles = (HANDLE*)malloc((size_t)threads * sizeof(HANDLE));
+#else
+    pthread_t* handles = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+#endif
+    bool* started = (bool*)calloc((size_t)threads, sizeof(bool));
+    if (!workers || !handles || !started) threads = 1;
+    
+    for (int t = 1; t < threads; t++) {
+        workers[t].job = &job;
+        workers[t].thread = t;
+#ifdef _WIN32
+        handles[t] = CreateThread(NULL, 0, fp_parallel_thread, &workers[t], 0, NULL);
+        started[t] = handles[t] != NULL;
+#else
+        started[t] = pthread_create(&handles[t], NULL, fp_parallel_thread, &workers[t]) == 0;
+#endif
+    }
+    
+    fp_parallel_worker_t self = {&job, 0};
+    fp_parallel_run(&self);
+    
+    for (int t = 1; t < threads; t++) {
+        if (!started[t]) continue;
+#ifdef _WIN32
+        WaitForSingleObject(handles[t], INFINITE);
+        CloseHandle(handles[t]);
+#else
+        pthread_join(handles[t], NULL);
+#endif
+    }
+    free(workers);
+    free(handles);
+    free(started);
+}
+
+// Called once per row. In unordered mode calls come from several threads at
+// once; thread identifies the worker (0..threads-1) for per-thread state.
+typedef void (*fp_csv_row_fn_t)(void* user, const fp_view_t* fields, size_t count, int thread);
+
+typedef struct {
+    int threads;            // 0 = one per CPU
+    size_t chunk_size;      // 0 = FP_PARALLEL_CHUNK_SIZE
+    bool ordered;           // deliver rows in file order (one call at a time)
+} fp_csv_parallel_options_t;
+
+typedef struct {
+    size_t rows;            // rows handed to the callback
+    int error_code;         // first error in file order, FP_OK if none
+    size_t error_offset;    // byte offset of that error into data
+} fp_csv_parallel_result_t;
+
+#define FP_CSV_NO_BOUNDARY ((size_t)-1)
+
+typedef struct {
+    size_t first_newline[2];    // first record end if the chunk starts outside / inside quotes
+    fp_csv_scan_state_t exit_state[2]; // scan state at the chunk end for either guess
+    size_t start;               // resolved first record start, FP_CSV_NO_BOUNDARY if none
+    size_t end;
+    size_t rows;
+    int error_code;             // first error in the chunk; parsing stopped there
+    size_t error_offset;
+} fp_csv_chunk_t;
+
+// Row state per worker; rows outgrowing the stack storage go to an arena
+// that doubles (and the row is parsed again) whenever a row doesn't fit
+typedef struct {
+    fp_view_t storage[FP_CSV_MAX_FIELDS];
+    fp_csv_row_t row;
+    fp_arena_t arena;
+} fp_csv_worker_t;
+
+typedef struct {
+    const char* data;
+    size_t len;
+    size_t chunk_size;
+    fp_csv_chunk_t* chunks;
+    fp_csv_worker_t* workers;
+    fp_csv_row_fn_t fn;
+    void* user;
+    bool ordered;
+    volatile size_t next_delivery;  // ordered mode: chunk whose rows go out next
+    bool stopped;                   // ordered mode: an earlier chunk failed, deliver nothing
+} fp_csv_parallel_t;
+
+// Scans [pos, end) from *state to the end; returns the first record end
+static inline size_t fp_csv_scan_range(const char* data, const char* pos, const char* end,
+                                       fp_csv_scan_state_t* state) {
+    const char* first = fp_csv_find_record_end(pos, end, state);
+    for (const char* at = first; at < end;) at = fp_csv_find_record_end(at + 1, end, state);
+    return first < end ? (size_t)(first - data) : FP_CSV_NO_BOUNDARY;
+}
+
+static inline void fp_csv_scan_chunk(void* ctx, size_t index, int thread) {
+    fp_csv_parallel_t* job = (fp_csv_parallel_t*)ctx;
+    fp_csv_chunk_t* chunk = &job->chunks[index];
+    const char* pos = job->data + index * job->chunk_size;
+    const char* end = job->data + (index + 1) * job->chunk_size;
+    if (end > job->data + job->len) end = job->data + job->len;
+    (void)thread;
+    
+    fp_csv_scan_state_t outside = FP_CSV_SCAN_FIELD, inside = FP_CSV_SCAN_QUOTED;
+    const char* in_end = fp_csv_find_record_end(pos, end, &inside);
+    const char* out_end = fp_csv_find_record_end(pos, end, &outside);
+    chunk->first_newline[0] = out_end < end ? (size_t)(out_end - job->data) : FP_CSV_NO_BOUNDARY;
+    chunk->first_newline[1] = in_end < end ? (size_t)(in_end - job->data) : FP_CSV_NO_BOUNDARY;
+    
+    // Both are at a record start after in_end if the outside guess ends a record there too
+    while (out_end < in_end) out_end = fp_csv_find_record_end(out_end + 1, end, &outside);
+    if (out_end == in_end && in_end < end) {
+        fp_csv_scan_state_t state = FP_CSV_SCAN_FIELD;
+        fp_csv_scan_range(job->data, in_end + 1, end, &state);
+        chunk->exit_state[0] = chunk->exit_state[1] = state;
+        return;
+    }
+    for (; out_end < end;) out_end = fp_csv_find_record_end(out_end + 1, end, &outside);
+    for (; in_end < end;) in_end = fp_csv_find_record_end(in_end + 1, end, &inside);
+    chunk->exit_state[0] = outside;
+    chunk->exit_state[1] = inside;
+}
+
+// Which guess from fp_csv_scan_chunk holds for a chunk entered in state:
+// 0 (outside quotes), 1 (inside) or -1 if the chunk must be rescanned
+static inline int fp_csv_chunk_guess(const char* pos, const char* end, fp_csv_scan_state_t state) {
+    if (state == FP_CSV_SCAN_FIELD) return 0;
+    if (state == FP_CSV_SCAN_QUOTED) return 1;
+    if (state == FP_CSV_SCAN_ESCAPE) return -1;
+    // Mid-field acts like a field start unless blanks and a quote come first
+    while (pos < end && (*pos == ' ' || *pos == '\t')) pos++;
+    return pos < end && *pos != '"' ? 0 : -1;
+}
+
+// Parses the next record at full width into the worker's row; false with the
+// error set on p if it fails (FP_ERROR_CUSTOM when the arena can't grow)
+static inline bool fp_csv_worker_row(fp_parser_t* p, fp_csv_worker_t* worker) {
+    fp_position_t start = fp_save_position(p);
+    for (;;) {
+        fp_parse_csv_row(p, &worker->row);
+        if (p->error_code != FP_ERROR_CAPACITY) return !fp_has_error(p);
+        
+        fp_restore_position(p, start);
+        size_t size = worker->arena.size ? worker->arena.size * 2 : 4 * FP_CSV_MAX_FIELDS * sizeof(fp_view_t);
+        char* grown = size > worker->arena.size ? (char*)realloc(worker->arena.base, size) : NULL;
+        if (!grown) {
+            fp_set_error(p, FP_ERROR_CUSTOM, "out of memory for a CSV row");
+            return false;
+        }
+        p->error_code = FP_OK;
+        worker->arena = fp_arena_init(grown, size);
+        worker->row = fp_csv_row_init(worker->storage, FP_CSV_MAX_FIELDS, &worker->arena);
+    }
+}
+
+static inline void fp_csv_chunk_fail(fp_csv_chunk_t* chunk, int code, size_t offset) {
+    chunk->error_code = code;
+    chunk->error_offset = offset;
+}
+
+static inline void fp_csv_parse_chunk(void* ctx, size_t index, int thread) {
+    fp_csv_parallel_t* job = (fp_csv_parallel_t*)ctx;
+    fp_csv_chunk_t* chunk = &job->chunks[index];
+    if (chunk->start == FP_CSV_NO_BOUNDARY) {
+        // No record starts here; still take the ordered-delivery turn
+        if (job->ordered) {
+            while (fp_atomic_load_acquire(&job->next_delivery) != index) fp_parallel_yield();
+            fp_atomic_store_release(&job->next_delivery, index + 1);
+        }
+        return;
+    }
+    
+    fp_parser_t p = fp_init(job->data + chunk->start, chunk->end - chunk->start);
+    fp_csv_worker_t* worker = &job->workers[thread];
+    fp_csv_row_t* row = &worker->row;
+    
+    // Like a sequential pass, stop at the first error; the failing row is not delivered
+    if (!job->ordered) {
+        while (!fp_at_end(&p)) {
+            if (!fp_csv_worker_row(&p, worker)) {
+                fp_csv_chunk_fail(chunk, p.error_code, chunk->start + p.error_offset);
+                break;
+            }
+            if (row->count == 0) continue;
+            job->fn(job->user, row->fields, row->count, thread);
+            chunk->rows++;
+        }
+        return;
+    }
+    
+    // Ordered: parse into a local buffer, then wait for our turn to deliver
+    size_t capacity = 1024, used = 0, rows = 0;
+    fp_view_t* buffer = (fp_view_t*)malloc(capacity * sizeof(fp_view_t));
+    size_t* counts = NULL;
+    size_t rows_capacity = 0;
+    if (!buffer) fp_csv_chunk_fail(chunk, FP_ERROR_CUSTOM, chunk->start);
+    while (buffer && !fp_at_end(&p)) {
+        size_t row_start = (size_t)(p.current - job->data);
+        if (!fp_csv_worker_row(&p, worker)) {
+            fp_csv_chunk_fail(chunk, p.error_code, chunk->start + p.error_offset);
+            break;
+        }
+        size_t count = row->count;
+        if (count == 0) continue;
+        if (used + count > capacity) {
+            while (used + count > capacity) capacity *= 2;
+            fp_view_t* grown = (fp_view_t*)realloc(buffer, capacity * sizeof(fp_view_t));
+            if (!grown) {
+                fp_csv_chunk_fail(chunk, FP_ERROR_CUSTOM, row_start);
+                break;
+            }
+            buffer = grown;
+        }
+        if (rows == rows_capacity) {
+            rows_capacity = rows_capacity ? rows_capacity * 2 : 256;
+            size_t* grown = (size_t*)realloc(counts, rows_capacity * sizeof(size_t));
+            if (!grown) {
+                fp_csv_chunk_fail(chunk, FP_ERROR_CUSTOM, row_start);
+                break;
+            }
+            counts = grown;
+        }
+        memcpy(buffer + used, row->fields, count * sizeof(fp_view_t));
+        used += count;
+        counts[rows++] = count;
+    }
+    
+    while (fp_atomic_load_acquire(&job->next_delivery) != index) fp_parallel_yield();
+    if (!job->stopped) {
+        size_t offset = 0;
+        for (size_t r = 0; r < rows; r++) {
+            job->fn(job->user, buffer + offset, counts[r], thread);
+            offset += counts[r];
+        }
+        chunk->rows = rows;
+        if (chunk->error_code != FP_OK) job->stopped = true;
+    }
+    fp_atomic_store_release(&job->next_delivery, index + 1);
+    free(buffer);
+    free(counts);
+}
+
+// Parses every row of data[0..len) in parallel. Rows are the records
+// fp_parse_csv_row would return (any width, one call each), views into data. Each chunk stops at its
+// first error (a failed allocation is FP_ERROR_CUSTOM) and the result holds
+// the first one in file order. Ordered mode delivers nothing past it; in
+// unordered mode later chunks have usually delivered their rows already.
+static inline fp_csv_parallel_result_t fp_parse_csv_parallel(const char* data, size_t len,
+                                                             const fp_csv_parallel_options_t* options,
+                                                             fp_csv_row_fn_t fn, void* user) {
+    fp_csv_parallel_result_t result = {0, FP_OK, 0};
+    fp_csv_parallel_options_t defaults = {0, 0, false};
+    if (!options) options = &defaults;
+    
+    fp_csv_parallel_t job;
+    job.data = data;
+    job.len = len;
+    job.chunk_size = options->chunk_size ? options->chunk_size : FP_PARALLEL_CHUNK_SIZE;
+    job.fn = fn;
+    job.user = user;
+    job.ordered = options->ordered;
+    job.next_delivery = 0;
+    job.stopped = false;
+    
+    size_t count = len ? (len + job.chunk_size - 1) / job.chunk_size : 0;
+    if (count == 0) return result;
+    job.chunks = (fp_csv_chunk_t*)calloc(count, sizeof(fp_csv_chunk_t));
+    if (!job.chunks) {
+        result.error_code = FP_ERROR_CUSTOM;
+        return result;
+    }
+    
+    fp_parallel_for(count, options->threads, fp_csv_scan_chunk, &job);
+    
+    // Scan state entering each chunk decides which candidate boundary is real
+    fp_csv_scan_state_t state = FP_CSV_SCAN_FIELD;
+    size_t last = 0;
+    job.chunks[0].start = 0;
+    for (size_t i = 0; i < count; i++) {
+        fp_csv_chunk_t* chunk = &job.chunks[i];
+        const char* pos = data + i * job.chunk_size;
+        const char* end = len - i * job.chunk_size > job.chunk_size ? pos + job.chunk_size : data + len;
+        int guess = fp_csv_chunk_guess(pos, end, state);
+        size_t newline;
+        if (guess >= 0) {
+            newline = chunk->first_newline[guess];
+            state = chunk->exit_state[guess];
+        } else {
+            newline = fp_csv_scan_range(data, pos, end, &state);
+        }
+        if (i > 0) {
+            chunk->start = newline == FP_CSV_NO_BOUNDARY ? FP_CSV_NO_BOUNDARY : newline + 1;
+            if (chunk->start == len) chunk->start = FP_CSV_NO_BOUNDARY;
+            if (chunk->start != FP_CSV_NO_BOUNDARY) {
+                job.chunks[last].end = chunk->start;
+                last = i;
+            }
+        }
+    }
+    job.chunks[last].end = len;
+    
+    // Same worker count fp_parallel_for settles on, one row state each
+    int threads = options->threads > 0 ? options->threads : fp_cpu_count();
+    if ((size_t)threads > count) threads = (int)count;
+    job.workers = (fp_csv_worker_t*)calloc((size_t)threads, sizeof(fp_csv_worker_t));
+    if (!job.workers) {
+        free(job.chunks);
+        result.error_code = FP_ERROR_CUSTOM;
+        return result;
+    }
+    for (int t = 0; t < threads; t++) {
+        fp_csv_worker_t* worker = &job.workers[t];
+        worker->row = fp_csv_row_init(worker->storage, FP_CSV_MAX_FIELDS, &worker->arena);
+    }
+    
+    fp_parallel_for(count, threads, fp_csv_parse_chunk, &job);
+    
+    for (size_t i = 0; i < count; i++) {
+        result.rows += job.chunks[i].rows;
+        if (result.error_code == FP_OK && job.chunks[i].error_code != FP_OK) {
+            result.error_code = job.chunks[i].error_code;
+            result.error_offset = job.chunks[i].error_offset;
+        }
+    }
+    for (int t = 0; t < threads; t++) free(job.workers[t].arena.base);
+    free(job.workers);
+    free(job.chunks);
+    return result;
+}
+
+// ============================================================================
+// NDJSON BATCHES
+// ============================================================================
+// Newline-delimited JSON: one document per line (raw newlines cannot occur
+// inside JSON, so no quote tracking is needed). The buffer is cut into chunks
+// at newlines; a first pass counts each chunk's lines with the SIMD newline
+// kernel so every document gets its global index, then the chunks are parsed
+// on worker threads. Each document gets its own parser, bounded to its line,
+// on which the on-demand JSON functions can be used directly.
+
+// Called once per non-blank line, concurrently from several threads. index is
+// the 0-based line number; doc->line is set to index + 1. With validate on,
+// doc already carries the error state of a failed skip (at its start).
+typedef void (*fp_ndjson_fn_t)(void* user, fp_parser_t* doc, size_t index, int thread);
+
+typedef struct {
+    int threads;            // 0 = one per CPU
+    size_t chunk_size;      // 0 = FP_PARALLEL_CHUNK_SIZE
+    bool validate;          // skip each document once before the callback
+} fp_ndjson_options_t;
+
+typedef struct {
+    size_t documents;
+    size_t errors;          // documents whose parser had an error after the callback
+    int error_code;         // FP_OK, or why the input could not be parsed at all
+} fp_ndjson_result_t;
+
+typedef struct {
+    size_t start;
+    size_t end;
+    size_t first_line;
+    size_t documents;
+    size_t errors;
+} fp_ndjson_chunk_t;
+
+typedef struct {
+    const char* data;
+    fp_ndjson_chunk_t* chunks;
+    fp_ndjson_fn_t fn;
+    void* user;
+    bool validate;
+} fp_ndjson_job_t;
+
+static inline void fp_ndjson_count_chunk(void* ctx, size_t index, int thread) {
+    fp_ndjson_job_t* job = (fp_ndjson_job_t*)ctx;
+    fp_ndjson_chunk_t* chunk = &job->chunks[index];
+    (void)thread;
+    chunk->first_line = fp_count_newlines(job->data + chunk->start, job->data + chunk->end);
+}
+
+// Marks doc with an error unless it holds exactly one JSON value
+static inline void fp_ndjson_validate(fp_parser_t* doc) {
+    fp_position_t begin = fp_save_position(doc);
+    if (fp_skip_json_value(doc)) {
+        fp_skip_ws(doc);
+        if (!fp_at_end(doc)) fp_set_error(doc, FP_ERROR_CUSTOM, "Trailing data after JSON document");
+    } else if (!fp_has_error(doc)) {
+        fp_set_error(doc, FP_ERROR_CUSTOM, "Invalid JSON document");
+    }
+    fp_restore_position(doc, begin);
+}
+
+static inline void fp_ndjson_parse_chunk(void* ctx, size_t index, int thread) {
+    fp_ndjson_job_t* job = (fp_ndjson_job_t*)ctx;
+    fp_ndjson_chunk_t* chunk = &job->chunks[index];
+    const char* pos = job->data + chunk->start;
+    const char* end = job->data + chunk->end;
+    size_t line = chunk->first_line;
+    
+    for (; pos < end; line++) {
+        const char* newline = (const char*)memchr(pos, '\n', (size_t)(end - pos));
+        const char* stop = newline ? newline : end;
+        const char* next = newline ? newline + 1 : end;
+        if (stop > pos && stop[-1] == '\r') stop--;
+        
+        if (fp_skip_whitespace(pos, stop) < stop) {
+            fp_parser_t doc = fp_init(pos, (size_t)(stop - pos));
+            doc.line = line + 1;
+            if (job->validate) fp_ndjson_validate(&doc);
+            job->fn(job->user, &doc, line, thread);
+            chunk->documents++;
+            if (fp_has_error(&doc)) chunk->errors++;
+        }
+        pos = next;
+    }
+}
+
+static inline fp_ndjson_result_t fp_parse_ndjson(const char* data, size_t len, const fp_ndjson_options_t* options,
+                                                 fp_ndjson_fn_t fn, void* user) {
+    fp_ndjson_result_t result = {0, 0, FP_OK};
+    fp_ndjson_options_t defaults = {0, 0, false};
+    if (!options) options = &defaults;
+    size_t chunk_size = options->chunk_size ? options->chunk_size : FP_PARALLEL_CHUNK_SIZE;
+    if (len == 0) return result;
+    
+    size_t capacity = len / chunk_size + 1;
+    fp_ndjson_job_t job = {data, NULL, fn, user, options->validate};
+    job.chunks = (fp_ndjson_chunk_t*)calloc(capacity, sizeof(fp_ndjson_chunk_t));
+    if (!job.chunks) {
+        result.error_code = FP_ERROR_CUSTOM;
+        return result;
+    }
+    
+    // Chunks end just after a newline at or past chunk_size bytes
+    size_t count = 0;
+    for (size_t start = 0; start < len; count++) {
+        size_t end = len - start > chunk_size ? start + chunk_size : len;
+        if (end < len) {
+            const char* newline = (const char*)memchr(data + end - 1, '\n', len - end + 1);
+            end = newline ? (size_t)(newline - data) + 1 : len;
+        }
+        job.chunks[count].start = start;
+        job.chunks[count].end = end;
+        start = end;
+    }
+    
+    fp_parallel_for(count, options->threads, fp_ndjson_count_chunk, &job);
+    size_t lines = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t chunk_lines = job.chunks[i].first_line;
+        job.chunks[i].first_line = lines;
+        lines += chunk_lines;
+    }
+    
+    fp_parallel_for(count, options->threads, fp_ndjson_parse_chunk, &job);
+    
+    for (size_t i = 0; i < count; i++) {
+        result.documents += job.chunks[i].documents;
+        result.errors += job.chunks[i].errors;
+    }
+    free(job.chunks);
+    return result;
+}
+
+#ifndef FP_NO_FILE_IO
+// Maps path (sequential access hint) and runs fp_parse_ndjson over it. False
+// if the file cannot be opened or mapped (error_code is then FP_ERROR_IO);
+// *result is filled either way.
+static inline bool fp_parse_ndjson_file(const char* path, const fp_ndjson_options_t* options,
+                                        fp_ndjson_fn_t fn, void* user, fp_ndjson_result_t* result) {
+    fp_ndjson_result_t empty = {0, 0, FP_OK};
+    *result = empty;
+    fp_mapped_t file = fp_open_mapped_ex(path, FP_MAP_SEQUENTIAL);
+    if (!fp_mapped_ok(&file)) {
+        result->error_code = FP_ERROR_IO;
+        fp_close_mapped(&file);
+        return false;
+    }
+    *result = fp_parse_ndjson(file.data, file.size, options, fn, user);
+    fp_close_mapped(&file);
+    return true;
+}
+#endif
+
+#endif // FP_NO_THREADS
+
+// ============================================================================
+// CHAINABLE PARSER COMBINATORS
+// ============================================================================
+
+typedef struct fp_chain fp_chain_t;
+struct fp_chain {
+    fp_parser_t* parser;
+    bool success;
+    fp_view_t result;
+};
+
+static inline fp_chain_t fp_chain(fp_parser_t* p) {
+    return (fp_chain_t){.parser = p, .success = true, .result = FP_VIEW_EMPTY()};
+}
+
+static inline fp_chain_t fp_then_skip_ws(fp_chain_t chain) {
+    if (chain.success) {
+        fp_skip_ws(chain.parser);
+    }
+    return chain;
+}
+
+static inline fp_chain_t fp_then_expect_char(fp_chain_t chain, char expected) {
+    if (chain.success) {
+        chain.success = fp_match_char(chain.parser, expected);
+        if (!chain.success) {
+            fp_set_error_arg(chain.parser, FP_ERROR_CUSTOM, "Expected '%c'", expected);
+        }
+    }
+    return chain;
+}
+
+static inline fp_chain_t fp_then_parse_string(fp_chain_t chain) {
+    if (chain.success) {
+        chain.success = fp_parse_quoted_string(chain.parser, &chain.result);
+    }
+    return chain;
+}
+
+// ============================================================================
+// UTILITY MACROS
+// ============================================================================
+
+#define FP_PARSE_OR_RETURN(parser, func, ...) \
+    do { \
+        if (!func(parser, __VA_ARGS__)) { \
+            return false; \
+        } \
+    } while(0)
+
+// The position is in fp_format_error's output, not the stored message
+#define FP_EXPECT_CHAR_OR_RETURN(parser, ch) \
+    do { \
+        if (!fp_match_char(parser, ch)) { \
+            fp_set_error_arg(parser, FP_ERROR_CUSTOM, "Expected '%c'", ch); \
+            return false; \
+        } \
+    } while(0)
+
+#define FP_CHAIN_BEGIN(parser) fp_chain(parser)
+#define FP_CHAIN_OK(chain) ((chain).success)
+#define FP_CHAIN_RESULT(chain) ((chain).result)
+
+// ============================================================================
+// PERFORMANCE BENCHMARKING
+// ============================================================================
+
+#ifdef FP_ENABLE_BENCHMARKS
+#include <time.h>
+
+static inline double fp_get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+#define FP_BENCHMARK(name, code) \
+    do { \
+        double start = fp_get_time_ms(); \
+        code; \
+        double end = fp_get_time_ms(); \
+        printf("Benchmark %s: %.3f ms\n", name, end - start); \
+    } while(0)
+#endif
+
+#ifdef __cplusplus
+}
+
+#if __cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+namespace fp {
+
+// Key set whose tables are built by the compiler:
+//     static constexpr auto fields = fp::make_keyset("id", "name", "email");
+//     int which = fields.find(key);
+//     fp_keyset_t set = fields.c_set();   // for fp_json_object_next_key etc.
+template <size_t N>
+struct keyset {
+    fp_view_t keys[N];
+    uint16_t displace[FP_KEYSET_BUCKETS(N)];
+    int16_t slots[FP_KEYSET_SLOTS(N)];
+    uint64_t seed;
+    bool ok;
+    
+    constexpr explicit keyset(const fp_view_t (&names)[N]) : keys{}, displace{}, slots{}, seed(0), ok(false) {
+        for (size_t i = 0; i < N; i++) keys[i] = names[i];
+        ok = fp_keyset_build_tables(keys, N, &seed, displace, slots);
+    }
+    
+    // C view for the fp_keyset_t functions; valid while this object lives
+    fp_keyset_t c_set() const {
+        fp_keyset_t set = {keys, ok ? (uint32_t)N : 0u, (uint32_t)FP_KEYSET_BUCKETS(N),
+                           (uint32_t)FP_KEYSET_SLOTS(N), seed, displace, slots};
+        return set;
+    }
+    
+    int find(fp_view_t key) const {
+        fp_keyset_t set = c_set();
+        return fp_keyset_find(&set, key);
+    }
+};
+
+template <size_t... L>
+constexpr keyset<sizeof...(L)> make_keyset(const char (&... names)[L]) {
+    return keyset<sizeof...(L)>({fp_view_t{names, L - 1}...});
+}
+
+} // namespace fp
+#endif
+#endif
+
+#endif // FASTPARSE_H
+
+/*
+ * USAGE EXAMPLES:
+ * 
+ * // Basic parsing
+ * fp_parser_t p = fp_init_cstr("42, hello, 3.14");
+ * int64_t num;
+ * fp_parse_int64(&p, &num); // num = 42
+ * 
+ * // CSV parsing
+ * fp_view_t fields[FP_CSV_MAX_FIELDS];
+ * size_t count = fp_parse_csv_line(&p, fields);
+ * 
+ * // Chainable operations
+ * auto chain = FP_CHAIN_BEGIN(&p)
+ *     .then_skip_ws()
+ *     .then_expect_char('{')
+ *     .then_parse_string();
+ * 
+ * // String views (zero-copy)
+ * fp_view_t view = FP_VIEW("hello");
+ * if (fp_view_equals(view, FP_VIEW("hello"))) {
+ *     // matches!
+ * }
  */
\ No newline at end of file
@@ -1,174 +1,1460 @@
-#ifndef TIMING_H
-#define TIMING_H
-
-#include <time.h>
-#include <stdio.h>
-#include <stdint.h>
-
-#ifdef _WIN32
-    #include <windows.h>
-#else
-    #include <sys/time.h>
-    #include <unistd.h>
-#endif
-
-/* Timer structure to hold timing data */
-typedef struct {
-    uint64_t start_time;
-    uint64_t end_time;
-    int is_running;
-} timer_t;
-
-/* Get high-resolution timestamp in nanoseconds */
-static inline uint64_t get_timestamp_ns(void) {
-#ifdef _WIN32
-    static LARGE_INTEGER frequency = {0};
-    LARGE_INTEGER counter;
-    
-    if (frequency.QuadPart == 0) {
-        QueryPerformanceFrequency(&frequency);
-    }
-    
-    QueryPerformanceCounter(&counter);
-    return (uint64_t)((counter.QuadPart * 1000000000ULL) / frequency.QuadPart);
-#else
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return (uint64_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
-#endif
-}
-
-/* Initialize a timer */
-static inline void timer_init(timer_t *t) {
-    t->start_time = 0;
-    t->end_time = 0;
-    t->is_running = 0;
-}
-
-/* Start timing */
-static inline void timer_start(timer_t *t) {
-    t->start_time = get_timestamp_ns();
-    t->is_running = 1;
-}
-
-/* Stop timing */
-static inline void timer_stop(timer_t *t) {
-    if (t->is_running) {
-        t->end_time = get_timestamp_ns();
-        t->is_running = 0;
-    }
-}
-
-/* Get elapsed time in nanoseconds */
-static inline uint64_t timer_elapsed_ns(const timer_t *t) {
-    if (t->is_running) {
-        return get_timestamp_ns() - t->start_time;
-    } else {
-        return t->end_time - t->start_time;
-    }
-}
-
-/* Get elapsed time in microseconds */
-static inline double timer_elapsed_us(const timer_t *t) {
-    return timer_elapsed_ns(t) / 1000.0;
-}
-
-/* Get elapsed time in milliseconds */
-static inline double timer_elapsed_ms(const timer_t *t) {
-    return timer_elapsed_ns(t) / 1000000.0;
-}
-
-/* Get elapsed time in seconds */
-static inline double timer_elapsed_s(const timer_t *t) {
-    return timer_elapsed_ns(t) / 1000000000.0;
-}
-
-/* Print elapsed time with appropriate unit */
-static inline void timer_print(const timer_t *t, const char *label) {
-    uint64_t ns = timer_elapsed_ns(t);
-    
-    if (label == NULL) label = "Elapsed";
-    
-    if (ns < 1000) {
-        printf("%s: %llu ns\n", label, (unsigned long long)ns);
-    } else if (ns < 1000000) {
-        printf("%s: %.3f us\n", label, ns / 1000.0);
-    } else if (ns < 1000000000) {
-        printf("%s: %.3f ms\n", label, ns / 1000000.0);
-    } else {
-        printf("%s: %.6f s\n", label, ns / 1000000000.0);
-    }
-}
-
-/* Convenience macros for quick timing */
-#define TIMER_START(name) \
-    timer_t name; \
-    timer_init(&name); \
-    timer_start(&name)
-
-#define TIMER_STOP_AND_PRINT(name, label) \
-    timer_stop(&name); \
-    timer_print(&name, label)
-
-/* Macro for timing a block of code */
-#define TIME_BLOCK(label, code) \
-    do { \
-        TIMER_START(__timer); \
-        code; \
-        TIMER_STOP_AND_PRINT(__timer, label); \
-    } while(0)
-
-/* Simple function timing - times a single function call */
-#define TIME_FUNCTION(func_call, label) \
-    do { \
-        TIMER_START(__timer); \
-        func_call; \
-        TIMER_STOP_AND_PRINT(__timer, label); \
-    } while(0)
-
-/* Benchmark a piece of code by running it multiple times */
-static inline double benchmark_code(void (*func)(void), int iterations, const char *label) {
-    timer_t t;
-    timer_init(&t);
-    
-    timer_start(&t);
-    for (int i = 0; i < iterations; i++) {
-        func();
-    }
-    timer_stop(&t);
-    
-    double total_ms = timer_elapsed_ms(&t);
-    double avg_ms = total_ms / iterations;
-    
-    if (label) {
-        printf("%s: %d iterations, %.6f ms total, %.6f ms average\n", 
-               label, iterations, total_ms, avg_ms);
-    }
-    
-    return avg_ms;
-}
-
-/* Sleep functions for precise delays */
-static inline void sleep_ns(uint64_t nanoseconds) {
-#ifdef _WIN32
-    /* Windows doesn't have nanosecond precision sleep, use microseconds */
-    if (nanoseconds >= 1000) {
-        Sleep((DWORD)(nanoseconds / 1000000));
-    }
-#else
-    struct timespec ts;
-    ts.tv_sec = nanoseconds / 1000000000ULL;
-    ts.tv_nsec = nanoseconds % 1000000000ULL;
-    nanosleep(&ts, NULL);
-#endif
-}
-
-static inline void sleep_us(uint64_t microseconds) {
-    sleep_ns(microseconds * 1000);
-}
-
-static inline void sleep_ms(uint64_t milliseconds) {
-    sleep_ns(milliseconds * 1000000);
-}
-
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <time.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/time.h>
+    #include <unistd.h>
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define TIMER_ARCH_X86 1
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+        #include <cpuid.h>
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define TIMER_ARCH_ARM64 1
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
+/* Hardware counters through perf_event_open (opt-in, Linux only) */
+#if defined(TIMER_ENABLE_PERF_COUNTERS) && defined(__linux__)
+    #define TIMER_HAS_PERF_COUNTERS 1
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+#endif
+
+/* Busy-wait used to calibrate the TSC against the OS clock */
+#ifndef TIMER_CALIBRATION_MS
+    #define TIMER_CALIBRATION_MS 20
+#endif
+
+/* Benchmark harness defaults (benchmark_run) */
+#ifndef BENCHMARK_SAMPLES
+    #define BENCHMARK_SAMPLES 30
+#endif
+
+#ifndef BENCHMARK_SAMPLE_MS
+    #define BENCHMARK_SAMPLE_MS 10.0
+#endif
+
+#ifndef BENCHMARK_WARMUP_MS
+    #define BENCHMARK_WARMUP_MS 100.0
+#endif
+
+/* Latency histograms: 2^SUB_BITS buckets per power of two (~0.8% error at 7),
+ * values up to 2^MAX_BITS ns (~4.9 hours at 44) */
+#ifndef TIMER_HIST_SUB_BITS
+    #define TIMER_HIST_SUB_BITS 7
+#endif
+
+#ifndef TIMER_HIST_MAX_BITS
+    #define TIMER_HIST_MAX_BITS 44
+#endif
+
+/* Threads alive at once with their own histogram shard / trace ring (an
+ * exiting thread hands its slot on); others share one shard and don't trace */
+#ifndef TIMER_HIST_MAX_THREADS
+    #define TIMER_HIST_MAX_THREADS 64
+#endif
+
+/* Profiling zones: events kept per thread (power of two, 16 bytes each),
+ * distinct zone names, and nesting depth matched at export */
+#ifndef TIMER_TRACE_RING_EVENTS
+    #define TIMER_TRACE_RING_EVENTS 65536
+#endif
+
+#ifndef TIMER_TRACE_MAX_ZONES
+    #define TIMER_TRACE_MAX_ZONES 1024
+#endif
+
+#ifndef TIMER_TRACE_MAX_DEPTH
+    #define TIMER_TRACE_MAX_DEPTH 64
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define TIMER_THREAD_LOCAL __declspec(thread)
+#else
+    #define TIMER_THREAD_LOCAL __thread
+#endif
+
+/* Timer structure to hold timing data (times are clock ticks, see timer_ticks_to_ns) */
+typedef struct {
+    uint64_t start_time;
+    uint64_t end_time;
+    int is_running;
+} timer_ctx_t;
+
+/* Old name; POSIX <time.h> has its own timer_t, so only kept on Windows */
+#ifdef _WIN32
+typedef timer_ctx_t timer_t;
+#endif
+
+/* Get high-resolution timestamp in nanoseconds */
+static inline uint64_t get_timestamp_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = {0};
+    LARGE_INTEGER counter;
+    
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    
+    QueryPerformanceCounter(&counter);
+    /* Split into seconds and remainder so counter * 1e9 can't overflow */
+    uint64_t ticks = (uint64_t)counter.QuadPart;
+    uint64_t freq = (uint64_t)frequency.QuadPart;
+    return (ticks / freq) * 1000000000ULL + (ticks % freq) * 1000000000ULL / freq;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+#endif
+}
+
+/* 64-bit atomics (clock init, histograms, trace rings) */
+#if defined(_MSC_VER) && !defined(__clang__)
+    static inline uint64_t timer_atomic_load(volatile uint64_t *ptr) {
+        uint64_t value = *ptr;
+        _ReadWriteBarrier();
+        return value;
+    }
+    static inline void timer_atomic_store(volatile uint64_t *ptr, uint64_t value) {
+        _ReadWriteBarrier();
+        *ptr = value;
+    }
+    static inline uint64_t timer_atomic_fetch_add(volatile uint64_t *ptr, uint64_t value) {
+        return (uint64_t)_InterlockedExchangeAdd64((volatile long long *)ptr, (long long)value);
+    }
+    static inline int timer_atomic_cas(volatile uint64_t *ptr, uint64_t *expected, uint64_t desired) {
+        uint64_t prev = (uint64_t)_InterlockedCompareExchange64((volatile long long *)ptr,
+                                                                (long long)desired, (long long)*expected);
+        if (prev == *expected) return 1;
+        *expected = prev;
+        return 0;
+    }
+#else
+    static inline uint64_t timer_atomic_load(volatile uint64_t *ptr) {
+        return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+    }
+    static inline void timer_atomic_store(volatile uint64_t *ptr, uint64_t value) {
+        __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+    }
+    static inline uint64_t timer_atomic_fetch_add(volatile uint64_t *ptr, uint64_t value) {
+        return __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED);
+    }
+    static inline int timer_atomic_cas(volatile uint64_t *ptr, uint64_t *expected, uint64_t desired) {
+        return __atomic_compare_exchange_n(ptr, expected, desired, 0,
+                                           __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    }
+#endif
+
+/*
+ * Fast clock: the TSC on x86 (when the CPU reports it invariant), the virtual
+ * counter on ARM64, otherwise get_timestamp_ns. Ticks become nanoseconds with
+ * ns = (ticks * mult) >> 32, using a 128-bit product. timer_clock_init
+ * calibrates once: the first caller measures while any others wait, and the
+ * clock is published before ready, so no thread ever sees it change. Calling
+ * it from main before starting threads just moves the ~20ms out of the way.
+ */
+typedef enum {
+    TIMER_CLOCK_OS = 0,
+    TIMER_CLOCK_TSC,
+    TIMER_CLOCK_CNTVCT
+} timer_clock_source_t;
+
+typedef struct {
+    volatile uint64_t ready;    /* 0 = not calibrated, 1 = calibrating, 2 = ready */
+    timer_clock_source_t source;
+    int has_rdtscp;
+    uint64_t mult;          /* ns per tick in 32.32 fixed point */
+    uint64_t frequency;     /* ticks per second */
+} timer_clock_t;
+
+static timer_clock_t g_timer_clock;
+
+#ifdef TIMER_ARCH_X86
+static inline void timer_cpuid(uint32_t leaf, uint32_t regs[4]) {
+#ifdef _MSC_VER
+    int r[4];
+    __cpuid(r, (int)leaf);
+    regs[0] = (uint32_t)r[0]; regs[1] = (uint32_t)r[1];
+    regs[2] = (uint32_t)r[2]; regs[3] = (uint32_t)r[3];
+#else
+    __cpuid(leaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+#endif
+
+/* Raw tick read, not ordered against surrounding instructions */
+static inline uint64_t timer_read_ticks_raw(void) {
+#if defined(TIMER_ARCH_X86)
+    if (g_timer_clock.source == TIMER_CLOCK_TSC) return __rdtsc();
+#elif defined(TIMER_ARCH_ARM64)
+    if (g_timer_clock.source == TIMER_CLOCK_CNTVCT) {
+#ifdef _MSC_VER
+        return (uint64_t)_ReadStatusReg(ARM64_CNTVCT);
+#else
+        uint64_t ticks;
+        __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#endif
+    }
+#endif
+    return get_timestamp_ns();
+}
+
+/* Start-of-region read: earlier instructions finish before the counter is read */
+static inline uint64_t timer_read_ticks(void) {
+#if defined(TIMER_ARCH_X86)
+    if (g_timer_clock.source == TIMER_CLOCK_TSC) {
+        _mm_lfence();
+        return __rdtsc();
+    }
+#elif defined(TIMER_ARCH_ARM64) && !defined(_MSC_VER)
+    if (g_timer_clock.source == TIMER_CLOCK_CNTVCT) {
+        uint64_t ticks;
+        __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks) :: "memory");
+        return ticks;
+    }
+#endif
+    return timer_read_ticks_raw();
+}
+
+/* End-of-region read: rdtscp waits for the measured code to retire */
+static inline uint64_t timer_read_ticks_end(void) {
+#if defined(TIMER_ARCH_X86)
+    if (g_timer_clock.source == TIMER_CLOCK_TSC && g_timer_clock.has_rdtscp) {
+        unsigned int aux;
+        uint64_t ticks = __rdtscp(&aux);
+        _mm_lfence();
+        return ticks;
+    }
+#endif
+    return timer_read_ticks();
+}
+
+static inline uint64_t timer_ticks_to_ns(uint64_t ticks) {
+#if defined(__SIZEOF_INT128__)
+    return (uint64_t)(((unsigned __int128)ticks * g_timer_clock.mult) >> 32);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    uint64_t low = _umul128(ticks, g_timer_clock.mult, &high);
+    return (high << 32) | (low >> 32);
+#else
+    /* 64x64 -> 128 in halves */
+    uint64_t a_lo = ticks & 0xFFFFFFFFULL, a_hi = ticks >> 32;
+    uint64_t b_lo = g_timer_clock.mult & 0xFFFFFFFFULL, b_hi = g_timer_clock.mult >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t mid = a_hi * b_lo + (lo_lo >> 32);
+    uint64_t mid2 = a_lo * b_hi + (mid & 0xFFFFFFFFULL);
+    uint64_t high = a_hi * b_hi + (mid >> 32) + (mid2 >> 32);
+    return (high << 32) | (mid2 & 0xFFFFFFFFULL);
+#endif
+}
+
+static inline void timer_clock_set(timer_clock_source_t source, uint64_t frequency) {
+    g_timer_clock.source = source;
+    g_timer_clock.frequency = frequency;
+    g_timer_clock.mult = (uint64_t)((1000000000.0 * 4294967296.0) / (double)frequency + 0.5);
+}
+
+/* Picks and calibrates the fast clock; safe to call again (no-op) */
+static inline void timer_clock_init(void) {
+    uint64_t state = timer_atomic_load(&g_timer_clock.ready);
+    if (state == 2) return;
+    if (state != 0 || !timer_atomic_cas(&g_timer_clock.ready, &state, 1)) {
+        /* Another thread is calibrating */
+        while (timer_atomic_load(&g_timer_clock.ready) != 2) {
+#ifdef _WIN32
+            SwitchToThread();
+#else
+            sched_yield();
+#endif
+        }
+        return;
+    }
+    
+    /* Measure into locals; nothing is published until the end */
+    timer_clock_source_t source = TIMER_CLOCK_OS;
+    uint64_t frequency = 1000000000ULL;
+    int has_rdtscp = 0;
+    
+#if defined(TIMER_ARCH_X86) && !defined(TIMER_NO_TSC)
+    uint32_t regs[4];
+    timer_cpuid(0x80000000U, regs);
+    uint32_t max_ext = regs[0];
+    int invariant = 0;
+    if (max_ext >= 0x80000001U) {
+        timer_cpuid(0x80000001U, regs);
+        has_rdtscp = (regs[3] >> 27) & 1;
+    }
+    if (max_ext >= 0x80000007U) {
+        timer_cpuid(0x80000007U, regs);
+        invariant = (regs[3] >> 8) & 1;
+    }
+#ifdef TIMER_FORCE_TSC
+    invariant = 1;
+#endif
+    if (invariant) {
+        /* Count ticks across a busy-wait of known OS-clock length */
+        uint64_t ns_start = get_timestamp_ns();
+        uint64_t tsc_start = __rdtsc();
+        uint64_t ns_end, tsc_end;
+        do {
+            ns_end = get_timestamp_ns();
+            tsc_end = __rdtsc();
+        } while (ns_end - ns_start < (uint64_t)TIMER_CALIBRATION_MS * 1000000ULL);
+        uint64_t tsc_frequency = (uint64_t)((double)(tsc_end - tsc_start) * 1e9 / (double)(ns_end - ns_start));
+        if (tsc_frequency > 0) {
+            source = TIMER_CLOCK_TSC;
+            frequency = tsc_frequency;
+        }
+    }
+#elif defined(TIMER_ARCH_ARM64) && !defined(TIMER_NO_TSC)
+    /* Fixed-rate counter; the architecture reports its frequency */
+    uint64_t counter_frequency;
+#ifdef _MSC_VER
+    counter_frequency = (uint64_t)_ReadStatusReg(ARM64_CNTFRQ);
+#else
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(counter_frequency));
+#endif
+    if (counter_frequency > 0) {
+        source = TIMER_CLOCK_CNTVCT;
+        frequency = counter_frequency;
+    }
+#endif
+    
+    g_timer_clock.has_rdtscp = has_rdtscp;
+    timer_clock_set(source, frequency);
+    timer_atomic_store(&g_timer_clock.ready, 2);  /* release: fields above first */
+}
+
+static inline const char *timer_clock_name(void) {
+    timer_clock_init();
+    switch (g_timer_clock.source) {
+        case TIMER_CLOCK_TSC: return "tsc";
+        case TIMER_CLOCK_CNTVCT: return "cntvct";
+        default: return "os";
+    }
+}
+
+/* Current time on the fast clock in nanoseconds (arbitrary epoch) */
+static inline uint64_t timer_now_ns(void) {
+    timer_clock_init();
+    return timer_ticks_to_ns(timer_read_ticks());
+}
+
+/* Initialize a timer */
+static inline void timer_init(timer_ctx_t *t) {
+    t->start_time = 0;
+    t->end_time = 0;
+    t->is_running = 0;
+}
+
+/* Start timing */
+static inline void timer_start(timer_ctx_t *t) {
+    timer_clock_init();
+    t->is_running = 1;
+    t->start_time = timer_read_ticks();
+}
+
+/* Stop timing */
+static inline void timer_stop(timer_ctx_t *t) {
+    if (t->is_running) {
+        t->end_time = timer_read_ticks_end();
+        t->is_running = 0;
+    }
+}
+
+/* Get elapsed time in nanoseconds */
+static inline uint64_t timer_elapsed_ns(const timer_ctx_t *t) {
+    if (t->is_running) {
+        return timer_ticks_to_ns(timer_read_ticks_end() - t->start_time);
+    } else {
+        return timer_ticks_to_ns(t->end_time - t->start_time);
+    }
+}
+
+/* Get elapsed time in microseconds */
+static inline double timer_elapsed_us(const timer_ctx_t *t) {
+    return timer_elapsed_ns(t) / 1000.0;
+}
+
+/* Get elapsed time in milliseconds */
+static inline double timer_elapsed_ms(const timer_ctx_t *t) {
+    return timer_elapsed_ns(t) / 1000000.0;
+}
+
+/* Get elapsed time in seconds */
+static inline double timer_elapsed_s(const timer_ctx_t *t) {
+    return timer_elapsed_ns(t) / 1000000000.0;
+}
+
+/* Print elapsed time with appropriate unit */
+static inline void timer_print(const timer_ctx_t *t, const char *label) {
+    uint64_t ns = timer_elapsed_ns(t);
+    
+    if (label == NULL) label = "Elapsed";
+    
+    if (ns < 1000) {
+        printf("%s: %llu ns\n", label, (unsigned long long)ns);
+    } else if (ns < 1000000) {
+        printf("%s: %.3f us\n", label, ns / 1000.0);
+    } else if (ns < 1000000000) {
+        printf("%s: %.3f ms\n", label, ns / 1000000.0);
+    } else {
+        printf("%s: %.6f s\n", label, ns / 1000000000.0);
+    }
+}
+
+/* Convenience macros for quick timing */
+#define TIMER_START(name) \
+    timer_ctx_t name; \
+    timer_init(&name); \
+    timer_start(&name)
+
+#define TIMER_STOP_AND_PRINT(name, label) \
+    timer_stop(&name); \
+    timer_print(&name, label)
+
+/* Macro for timing a block of code */
+#define TIME_BLOCK(label, code) \
+    do { \
+        TIMER_START(__timer); \
+        code; \
+        TIMER_STOP_AND_PRINT(__timer, label); \
+    } while(0)
+
+/* Simple function timing - times a single function call */
+#define TIME_FUNCTION(func_call, label) \
+    do { \
+        TIMER_START(__timer); \
+        func_call; \
+        TIMER_STOP_AND_PRINT(__timer, label); \
+    } while(0)
+
+/* Benchmark a piece of code by running it multiple times (one loop, mean only; see benchmark_run) */
+static inline double benchmark_code(void (*func)(void), int iterations, const char *label) {
+    timer_ctx_t t;
+    timer_init(&t);
+    
+    timer_start(&t);
+    for (int i = 0; i < iterations; i++) {
+        func();
+    }
+    timer_stop(&t);
+    
+    double total_ms = timer_elapsed_ms(&t);
+    double avg_ms = total_ms / iterations;
+    
+    if (label) {
+        printf("%s: %d iterations, %.6f ms total, %.6f ms average\n", 
+               label, iterations, total_ms, avg_ms);
+    }
+    
+    return avg_ms;
+}
+
+/*
+ * Benchmark harness: warms up, picks an iteration count so one sample takes
+ * about sample_ms, then times samples of that many calls. Per-call min,
+ * median, p99 and max come from all samples; mean and stddev are computed
+ * after dropping outliers outside 1.5 IQR of the quartiles. Throughput uses
+ * the median.
+ */
+
+/* Keep a value (scalar or pointer) alive / force memory to be written */
+#if defined(__GNUC__) || defined(__clang__)
+    #define BENCHMARK_DO_NOT_OPTIMIZE(value) __asm__ __volatile__("" : : "r,m"(value) : "memory")
+    #define BENCHMARK_CLOBBER() __asm__ __volatile__("" : : : "memory")
+#else
+    /* Needs an lvalue here: its address escapes through a volatile store */
+    static volatile const void *g_benchmark_sink;
+    #define BENCHMARK_DO_NOT_OPTIMIZE(value) (g_benchmark_sink = (const void *)&(value), _ReadWriteBarrier())
+    #define BENCHMARK_CLOBBER() _ReadWriteBarrier()
+#endif
+
+typedef void (*benchmark_fn_t)(void *ctx);
+
+typedef struct {
+    const char *name;
+    int samples;                /* 0 = BENCHMARK_SAMPLES */
+    double sample_ms;           /* 0 = BENCHMARK_SAMPLE_MS */
+    double warmup_ms;           /* 0 = BENCHMARK_WARMUP_MS, < 0 = none */
+    uint64_t iterations;        /* calls per sample, 0 = calibrate */
+    uint64_t bytes_per_call;    /* for bytes/s, 0 = not reported */
+    uint64_t items_per_call;    /* for items/s, 0 = not reported */
+} benchmark_config_t;
+
+typedef struct {
+    const char *name;
+    uint64_t iterations;        /* calls per sample */
+    int samples;
+    int outliers;
+    double min_ns;              /* all per call */
+    double median_ns;
+    double p99_ns;
+    double max_ns;
+    double mean_ns;
+    double stddev_ns;
+    double bytes_per_sec;
+    double items_per_sec;
+} benchmark_result_t;
+
+static inline int benchmark_compare(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Newton's method, so the harness doesn't need libm */
+static inline double benchmark_sqrt(double x) {
+    if (x <= 0) return 0;
+    double r = x > 1 ? x : 1;
+    for (int i = 0; i < 64; i++) {
+        double next = 0.5 * (r + x / r);
+        if (next >= r) break;
+        r = next;
+    }
+    return r;
+}
+
+/* Nearest-rank percentile of sorted values */
+static inline double benchmark_percentile(const double *sorted, int count, double p) {
+    int rank = (int)(p / 100.0 * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+/* Ticks spent in `iterations` calls */
+static inline uint64_t benchmark_sample(benchmark_fn_t fn, void *ctx, uint64_t iterations) {
+    uint64_t start = timer_read_ticks();
+    for (uint64_t i = 0; i < iterations; i++) {
+        fn(ctx);
+    }
+    return timer_read_ticks_end() - start;
+}
+
+static inline benchmark_result_t benchmark_run(const benchmark_config_t *config, benchmark_fn_t fn, void *ctx) {
+    benchmark_result_t r;
+    memset(&r, 0, sizeof(r));
+    r.name = config->name ? config->name : "benchmark";
+    
+    int samples = config->samples > 0 ? config->samples : BENCHMARK_SAMPLES;
+    double sample_ms = config->sample_ms > 0 ? config->sample_ms : BENCHMARK_SAMPLE_MS;
+    double warmup_ms = config->warmup_ms != 0 ? config->warmup_ms : BENCHMARK_WARMUP_MS;
+    uint64_t sample_ns = (uint64_t)(sample_ms * 1e6);
+    timer_clock_init();
+    
+    /* Warmup: caches, branch predictors, CPU frequency */
+    if (warmup_ms > 0) {
+        uint64_t warmup_ns = (uint64_t)(warmup_ms * 1e6);
+        uint64_t start = timer_now_ns();
+        uint64_t batch = 1;
+        while (timer_now_ns() - start < warmup_ns) {
+            benchmark_sample(fn, ctx, batch);
+            if (batch < (1ULL << 20)) batch *= 2;
+        }
+    }
+    
+    /* Calibrate: grow the call count until one sample reaches sample_ms */
+    uint64_t iterations = config->iterations;
+    if (iterations == 0) {
+        iterations = 1;
+        for (;;) {
+            uint64_t ns = timer_ticks_to_ns(benchmark_sample(fn, ctx, iterations));
+            if (ns >= sample_ns || iterations >= (1ULL << 40)) break;
+            uint64_t grow = ns > 0 ? (uint64_t)((double)sample_ns / (double)ns * 1.2) : 10;
+            if (grow < 2) grow = 2;
+            if (grow > 10) grow = 10;
+            iterations *= grow;
+        }
+    }
+    r.iterations = iterations;
+    
+    double *per_call = (double *)malloc((size_t)samples * sizeof(double));
+    if (!per_call) return r;
+    for (int i = 0; i < samples; i++) {
+        per_call[i] = (double)timer_ticks_to_ns(benchmark_sample(fn, ctx, iterations)) / (double)iterations;
+    }
+    qsort(per_call, (size_t)samples, sizeof(double), benchmark_compare);
+    
+    r.samples = samples;
+    r.min_ns = per_call[0];
+    r.max_ns = per_call[samples - 1];
+    r.median_ns = samples % 2 ? per_call[samples / 2] : 0.5 * (per_call[samples / 2 - 1] + per_call[samples / 2]);
+    r.p99_ns = benchmark_percentile(per_call, samples, 99.0);
+    
+    /* Tukey fences for mean/stddev */
+    double q1 = benchmark_percentile(per_call, samples, 25.0);
+    double q3 = benchmark_percentile(per_call, samples, 75.0);
+    double low = q1 - 1.5 * (q3 - q1), high = q3 + 1.5 * (q3 - q1);
+    double sum = 0, sum_sq = 0;
+    int kept = 0;
+    for (int i = 0; i < samples; i++) {
+        if (per_call[i] < low || per_call[i] > high) continue;
+        sum += per_call[i];
+        kept++;
+    }
+    r.outliers = samples - kept;
+    r.mean_ns = kept ? sum / kept : 0;
+    for (int i = 0; i < samples; i++) {
+        if (per_call[i] < low || per_call[i] > high) continue;
+        sum_sq += (per_call[i] - r.mean_ns) * (per_call[i] - r.mean_ns);
+    }
+    r.stddev_ns = kept > 1 ? benchmark_sqrt(sum_sq / (kept - 1)) : 0;
+    free(per_call);
+    
+    if (r.median_ns > 0) {
+        r.bytes_per_sec = (double)config->bytes_per_call * 1e9 / r.median_ns;
+        r.items_per_sec = (double)config->items_per_call * 1e9 / r.median_ns;
+    }
+    return r;
+}
+
+/* Time with an appropriate unit into buf */
+static inline const char *benchmark_format_ns(double ns, char *buf, size_t size) {
+    if (ns < 1000) snprintf(buf, size, "%.2f ns", ns);
+    else if (ns < 1000000) snprintf(buf, size, "%.3f us", ns / 1000.0);
+    else if (ns < 1000000000) snprintf(buf, size, "%.3f ms", ns / 1000000.0);
+    else snprintf(buf, size, "%.6f s", ns / 1000000000.0);
+    return buf;
+}
+
+static inline void benchmark_print(const benchmark_result_t *r) {
+    char median[32], min[32], p99[32], stddev[32];
+    printf("%s: %s median (min %s, p99 %s, stddev %s)",
+           r->name,
+           benchmark_format_ns(r->median_ns, median, sizeof(median)),
+           benchmark_format_ns(r->min_ns, min, sizeof(min)),
+           benchmark_format_ns(r->p99_ns, p99, sizeof(p99)),
+           benchmark_format_ns(r->stddev_ns, stddev, sizeof(stddev)));
+    if (r->bytes_per_sec > 0) printf(", %.3f GB/s", r->bytes_per_sec / 1e9);
+    if (r->items_per_sec > 0) printf(", %.3f M items/s", r->items_per_sec / 1e6);
+    printf(", %d x %llu calls, %d outliers\n", r->samples, (unsigned long long)r->iterations, r->outliers);
+}
+
+static inline void benchmark_write_json_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', out);
+        if ((unsigned char)*s < 0x20) fprintf(out, "\\u%04x", (unsigned char)*s);
+        else fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+/* {"benchmarks": [{...}, ...]}, one object per result */
+static inline void benchmark_write_json(FILE *out, const benchmark_result_t *results, int count) {
+    fprintf(out, "{\n  \"clock\": \"%s\",\n  \"benchmarks\": [\n", timer_clock_name());
+    for (int i = 0; i < count; i++) {
+        const benchmark_result_t *r = &results[i];
+        fprintf(out, "    {\"name\": ");
+        benchmark_write_json_string(out, r->name);
+        fprintf(out, ", \"iterations\": %llu, \"samples\": %d, \"outliers\": %d, "
+                     "\"min_ns\": %.3f, \"median_ns\": %.3f, \"p99_ns\": %.3f, \"max_ns\": %.3f, "
+                     "\"mean_ns\": %.3f, \"stddev_ns\": %.3f, \"bytes_per_sec\": %.1f, \"items_per_sec\": %.1f}%s\n",
+                (unsigned long long)r->iterations, r->samples, r->outliers,
+                r->min_ns, r->median_ns, r->p99_ns, r->max_ns, r->mean_ns, r->stddev_ns,
+                r->bytes_per_sec, r->items_per_sec, i + 1 < count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+/* Header line plus one row per result; names are quoted */
+static inline void benchmark_write_csv(FILE *out, const benchmark_result_t *results, int count) {
+    fprintf(out, "name,iterations,samples,outliers,min_ns,median_ns,p99_ns,max_ns,mean_ns,stddev_ns,bytes_per_sec,items_per_sec\n");
+    for (int i = 0; i < count; i++) {
+        const benchmark_result_t *r = &results[i];
+        fputc('"', out);
+        for (const char *s = r->name; *s; s++) {
+            if (*s == '"') fputc('"', out);
+            fputc(*s, out);
+        }
+        fprintf(out, "\",%llu,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%.1f\n",
+                (unsigned long long)r->iterations, r->samples, r->outliers,
+                r->min_ns, r->median_ns, r->p99_ns, r->max_ns, r->mean_ns, r->stddev_ns,
+                r->bytes_per_sec, r->items_per_sec);
+    }
+}
+
+/*
+ * Hardware counters: user-space cycles, instructions, branch misses, L1D
+ * read misses and LLC misses of the calling thread, accumulated over
+ * timer_counters_start/stop pairs. Multiplexed counts are scaled by
+ * enabled/running time. Needs -DTIMER_ENABLE_PERF_COUNTERS on Linux; on
+ * other platforms, or where perf_event_open is refused (perf_event_paranoid,
+ * most VMs and containers), counters are unavailable and the calls do
+ * nothing.
+ */
+typedef enum {
+    TIMER_COUNTER_CYCLES = 0,
+    TIMER_COUNTER_INSTRUCTIONS,
+    TIMER_COUNTER_BRANCH_MISSES,
+    TIMER_COUNTER_L1D_MISSES,
+    TIMER_COUNTER_LLC_MISSES,
+    TIMER_COUNTER_COUNT
+} timer_counter_t;
+
+typedef struct {
+    int fd[TIMER_COUNTER_COUNT];            /* -1 = unavailable */
+    uint64_t start[TIMER_COUNTER_COUNT][3]; /* value, time enabled, time running */
+    uint64_t value[TIMER_COUNTER_COUNT];
+} timer_counters_t;
+
+static inline const char *timer_counter_name(timer_counter_t counter) {
+    switch (counter) {
+        case TIMER_COUNTER_CYCLES: return "cycles";
+        case TIMER_COUNTER_INSTRUCTIONS: return "instructions";
+        case TIMER_COUNTER_BRANCH_MISSES: return "branch-misses";
+        case TIMER_COUNTER_L1D_MISSES: return "l1d-misses";
+        case TIMER_COUNTER_LLC_MISSES: return "llc-misses";
+        default: return "?";
+    }
+}
+
+static inline int timer_counters_available(const timer_counters_t *c, timer_counter_t counter) {
+    return c->fd[counter] >= 0;
+}
+
+/* Returns how many counters opened */
+static inline int timer_counters_open(timer_counters_t *c) {
+    int opened = 0;
+    memset(c, 0, sizeof(*c));
+    for (int i = 0; i < TIMER_COUNTER_COUNT; i++) {
+        c->fd[i] = -1;
+#ifdef TIMER_HAS_PERF_COUNTERS
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        switch (i) {
+            case TIMER_COUNTER_CYCLES: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+            case TIMER_COUNTER_INSTRUCTIONS: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+            case TIMER_COUNTER_BRANCH_MISSES: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+            case TIMER_COUNTER_L1D_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case TIMER_COUNTER_LLC_MISSES: attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        }
+        /* This thread, any CPU, counting from now on */
+        c->fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (c->fd[i] >= 0) opened++;
+        else c->fd[i] = -1;
+#endif
+    }
+    return opened;
+}
+
+static inline void timer_counters_close(timer_counters_t *c) {
+    for (int i = 0; i < TIMER_COUNTER_COUNT; i++) {
+#ifdef TIMER_HAS_PERF_COUNTERS
+        if (c->fd[i] >= 0) close(c->fd[i]);
+#endif
+        c->fd[i] = -1;
+    }
+}
+
+static inline int timer_counters_read(const timer_counters_t *c, int i, uint64_t out[3]) {
+#ifdef TIMER_HAS_PERF_COUNTERS
+    return c->fd[i] >= 0 && read(c->fd[i], out, 3 * sizeof(uint64_t)) == (ssize_t)(3 * sizeof(uint64_t));
+#else
+    (void)c; (void)i; (void)out;
+    return 0;
+#endif
+}
+
+static inline void timer_counters_start(timer_counters_t *c) {
+    for (int i = 0; i < TIMER_COUNTER_COUNT; i++) {
+        if (!timer_counters_read(c, i, c->start[i])) c->start[i][0] = c->start[i][1] = c->start[i][2] = 0;
+    }
+}
+
+static inline void timer_counters_stop(timer_counters_t *c) {
+    for (int i = TIMER_COUNTER_COUNT - 1; i >= 0; i--) {
+        uint64_t now[3];
+        if (!timer_counters_read(c, i, now)) continue;
+        uint64_t value = now[0] - c->start[i][0];
+        uint64_t enabled = now[1] - c->start[i][1];
+        uint64_t running = now[2] - c->start[i][2];
+        if (running > 0 && running < enabled) {
+            value = (uint64_t)((double)value * (double)enabled / (double)running);
+        }
+        c->value[i] += value;
+    }
+}
+
+static inline void timer_counters_reset(timer_counters_t *c) {
+    memset(c->value, 0, sizeof(c->value));
+}
+
+static inline uint64_t timer_counters_value(const timer_counters_t *c, timer_counter_t counter) {
+    return c->value[counter];
+}
+
+/* Instructions per cycle, 0 if either counter is missing */
+static inline double timer_counters_ipc(const timer_counters_t *c) {
+    if (!timer_counters_available(c, TIMER_COUNTER_CYCLES) ||
+        !timer_counters_available(c, TIMER_COUNTER_INSTRUCTIONS) ||
+        c->value[TIMER_COUNTER_CYCLES] == 0) return 0.0;
+    return (double)c->value[TIMER_COUNTER_INSTRUCTIONS] / (double)c->value[TIMER_COUNTER_CYCLES];
+}
+
+/* Counts divided by per (calls, bytes, ...) plus IPC, on one line */
+static inline void timer_counters_print(const timer_counters_t *c, const char *label, double per, const char *per_unit) {
+    if (label == NULL) label = "Counters";
+    if (per <= 0) per = 1;
+    printf("%s:", label);
+    int any = 0;
+    for (int i = 0; i < TIMER_COUNTER_COUNT; i++) {
+        if (!timer_counters_available(c, (timer_counter_t)i)) continue;
+        printf(" %.3f %s%s%s,", (double)c->value[i] / per, timer_counter_name((timer_counter_t)i),
+               per_unit ? "/" : "", per_unit ? per_unit : "");
+        any = 1;
+    }
+    if (any) printf(" %.2f IPC\n", timer_counters_ipc(c));
+    else printf(" no counters available\n");
+}
+
+/* Run fn for iterations calls between start/stop, e.g. after benchmark_run
+ * with its calibrated call count */
+static inline void benchmark_count(benchmark_fn_t fn, void *ctx, uint64_t iterations, timer_counters_t *c) {
+    timer_counters_start(c);
+    for (uint64_t i = 0; i < iterations; i++) fn(ctx);
+    timer_counters_stop(c);
+}
+
+/*
+ * Latency histograms (HDR-style, log-linear). Values below 2^(SUB_BITS+1) ns
+ * get a bucket each; above that every power of two is split into 2^SUB_BITS
+ * buckets, so a bucket is never wider than 1/2^SUB_BITS of its value. Counts
+ * are fixed arrays (~38KB at the defaults): recording is constant time and
+ * never allocates.
+ *
+ * A timer_histogram_t has one writer (timer_histogram_record) or many
+ * (timer_histogram_record_atomic). timer_histogram_set_t gives each thread
+ * its own shard so recording stays uncontended; readers merge the shards,
+ * and a snapshot can move a baseline instead of zeroing under the writers.
+ */
+
+#define TIMER_HIST_SUB_COUNT (1U << TIMER_HIST_SUB_BITS)
+#define TIMER_HIST_BUCKETS ((TIMER_HIST_MAX_BITS - TIMER_HIST_SUB_BITS + 1) << TIMER_HIST_SUB_BITS)
+
+/* Zero-initialized is empty; min is stored inverted so that holds */
+typedef struct {
+    volatile uint64_t counts[TIMER_HIST_BUCKETS];
+    volatile uint64_t total;
+    volatile uint64_t sum_ns;
+    volatile uint64_t min_inv;
+    volatile uint64_t max_ns;
+} timer_histogram_t;
+
+/* Per-thread shards (allocated on a thread's first record) plus the
+ * baseline of the last resetting snapshot */
+typedef struct {
+    const char *name;
+    volatile uint64_t shards[TIMER_HIST_MAX_THREADS + 1];
+    timer_histogram_t *baseline;
+} timer_histogram_set_t;
+
+/* Define a named histogram set: TIMER_HISTOGRAM(parse_latency); */
+#define TIMER_HISTOGRAM(name) static timer_histogram_set_t name = {#name, {0}, NULL}
+
+static volatile uint64_t g_timer_slot_used[TIMER_HIST_MAX_THREADS];
+static volatile uint64_t g_timer_slot_key = 0;  /* exit hook key + 1, 0 = not created */
+static TIMER_THREAD_LOCAL uint64_t t_timer_thread_slot = 0;  /* slot + 1, 0 = unassigned */
+static TIMER_THREAD_LOCAL int t_timer_slot_fresh = 0;        /* claimed, ring not touched yet */
+
+/* Thread exit: the slot's shards and ring stay, the next new thread takes them over */
+static inline void timer_thread_slot_release(void *value) {
+    uint64_t slot = (uint64_t)(uintptr_t)value - 1;
+    t_timer_thread_slot = 0;  /* a later record (another exit hook) claims again */
+    if (slot < TIMER_HIST_MAX_THREADS) timer_atomic_store(&g_timer_slot_used[slot], 0);
+}
+
+#ifdef _WIN32
+static VOID WINAPI timer_thread_slot_release_fls(PVOID value) {
+    if (value) timer_thread_slot_release(value);
+}
+#endif
+
+/* Arrange for the slot to be released at thread exit; without a key (none
+ * could be created) it stays taken */
+static inline void timer_thread_slot_hook(uint64_t slot) {
+    uint64_t key = timer_atomic_load(&g_timer_slot_key);
+    if (key == 0) {
+#ifdef _WIN32
+        DWORD created = FlsAlloc(timer_thread_slot_release_fls);
+        if (created == FLS_OUT_OF_INDEXES) return;
+#else
+        pthread_key_t created;
+        if (pthread_key_create(&created, timer_thread_slot_release) != 0) return;
+#endif
+        if (timer_atomic_cas(&g_timer_slot_key, &key, (uint64_t)created + 1)) {
+            key = (uint64_t)created + 1;
+        } else {
+#ifdef _WIN32
+            FlsFree(created);  /* another thread's key won */
+#else
+            pthread_key_delete(created);
+#endif
+        }
+    }
+#ifdef _WIN32
+    FlsSetValue((DWORD)(key - 1), (PVOID)(uintptr_t)(slot + 1));
+#else
+    pthread_setspecific((pthread_key_t)(key - 1), (void *)(uintptr_t)(slot + 1));
+#endif
+}
+
+/* Small per-thread index, 0..TIMER_HIST_MAX_THREADS; the last is shared by
+ * threads that found every slot taken (they keep it for life) */
+static inline uint64_t timer_thread_slot(void) {
+    if (t_timer_thread_slot == 0) {
+        uint64_t slot = TIMER_HIST_MAX_THREADS;
+        for (uint64_t i = 0; i < TIMER_HIST_MAX_THREADS; i++) {
+            uint64_t expected = 0;
+            if (timer_atomic_load(&g_timer_slot_used[i]) == 0 &&
+                timer_atomic_cas(&g_timer_slot_used[i], &expected, 1)) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < TIMER_HIST_MAX_THREADS) {
+            timer_thread_slot_hook(slot);
+            t_timer_slot_fresh = 1;
+        }
+        t_timer_thread_slot = slot + 1;
+    }
+    return t_timer_thread_slot - 1;
+}
+
+static inline int timer_msb64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return (int)index;
+#else
+    int msb = 0;
+    while (x >>= 1) msb++;
+    return msb;
+#endif
+}
+
+/* Bucket holding a value; values past 2^MAX_BITS land in the last one */
+static inline uint32_t timer_histogram_index(uint64_t ns) {
+    if (ns < 2 * TIMER_HIST_SUB_COUNT) return (uint32_t)ns;
+    if (ns >> TIMER_HIST_MAX_BITS) return TIMER_HIST_BUCKETS - 1;
+    int shift = timer_msb64(ns) - TIMER_HIST_SUB_BITS;
+    return ((uint32_t)(shift + 1) << TIMER_HIST_SUB_BITS) + (uint32_t)(ns >> shift) - TIMER_HIST_SUB_COUNT;
+}
+
+/* Smallest and largest value that map to a bucket */
+static inline uint64_t timer_histogram_lowest(uint32_t index) {
+    if (index < 2 * TIMER_HIST_SUB_COUNT) return index;
+    uint32_t group = index >> TIMER_HIST_SUB_BITS;
+    return (uint64_t)(TIMER_HIST_SUB_COUNT + (index & (TIMER_HIST_SUB_COUNT - 1))) << (group - 1);
+}
+
+static inline uint64_t timer_histogram_highest(uint32_t index) {
+    if (index < 2 * TIMER_HIST_SUB_COUNT) return index;
+    return timer_histogram_lowest(index) + (1ULL << ((index >> TIMER_HIST_SUB_BITS) - 1)) - 1;
+}
+
+/* Single writer: plain stores, readers on other threads still see untorn values */
+static inline void timer_histogram_record(timer_histogram_t *h, uint64_t ns) {
+    volatile uint64_t *count = &h->counts[timer_histogram_index(ns)];
+    timer_atomic_store(count, *count + 1);
+    timer_atomic_store(&h->total, h->total + 1);
+    timer_atomic_store(&h->sum_ns, h->sum_ns + ns);
+    if (~ns > h->min_inv) timer_atomic_store(&h->min_inv, ~ns);
+    if (ns > h->max_ns) timer_atomic_store(&h->max_ns, ns);
+}
+
+/* Any number of writers */
+static inline void timer_histogram_record_atomic(timer_histogram_t *h, uint64_t ns) {
+    timer_atomic_fetch_add(&h->counts[timer_histogram_index(ns)], 1);
+    timer_atomic_fetch_add(&h->total, 1);
+    timer_atomic_fetch_add(&h->sum_ns, ns);
+    uint64_t seen = timer_atomic_load(&h->min_inv);
+    while (~ns > seen && !timer_atomic_cas(&h->min_inv, &seen, ~ns)) {}
+    seen = timer_atomic_load(&h->max_ns);
+    while (ns > seen && !timer_atomic_cas(&h->max_ns, &seen, ns)) {}
+}
+
+/* Only while nothing records into h */
+static inline void timer_histogram_reset(timer_histogram_t *h) {
+    memset((void *)h, 0, sizeof(*h));
+}
+
+/* dst += src; dst must not be recorded into meanwhile, src may be */
+static inline void timer_histogram_merge(timer_histogram_t *dst, timer_histogram_t *src) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < TIMER_HIST_BUCKETS; i++) {
+        uint64_t count = timer_atomic_load(&src->counts[i]);
+        dst->counts[i] += count;
+        total += count;
+    }
+    /* Total from the buckets read, so percentiles stay consistent */
+    dst->total += total;
+    dst->sum_ns += timer_atomic_load(&src->sum_ns);
+    uint64_t min_inv = timer_atomic_load(&src->min_inv);
+    uint64_t max_ns = timer_atomic_load(&src->max_ns);
+    if (min_inv > dst->min_inv) dst->min_inv = min_inv;
+    if (max_ns > dst->max_ns) dst->max_ns = max_ns;
+}
+
+static inline uint64_t timer_histogram_count(const timer_histogram_t *h) {
+    return h->total;
+}
+
+static inline uint64_t timer_histogram_min(const timer_histogram_t *h) {
+    return h->total ? ~h->min_inv : 0;
+}
+
+static inline uint64_t timer_histogram_max(const timer_histogram_t *h) {
+    return h->max_ns;
+}
+
+static inline double timer_histogram_mean(const timer_histogram_t *h) {
+    return h->total ? (double)h->sum_ns / (double)h->total : 0.0;
+}
+
+/* Value at percentile p (0-100): the top of the bucket holding that rank,
+ * clamped to the recorded min/max. 0 when empty */
+static inline uint64_t timer_histogram_percentile(const timer_histogram_t *h, double p) {
+    if (h->total == 0) return 0;
+    if (p < 0) p = 0;
+    if (p > 100) p = 100;
+    uint64_t rank = (uint64_t)(p / 100.0 * (double)h->total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > h->total) rank = h->total;
+    
+    uint64_t seen = 0;
+    uint64_t value = h->max_ns;
+    for (uint32_t i = 0; i < TIMER_HIST_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            value = timer_histogram_highest(i);
+            break;
+        }
+    }
+    if (value > h->max_ns) value = h->max_ns;
+    if (value < ~h->min_inv) value = ~h->min_inv;
+    return value;
+}
+
+/* The calling thread's shard; the last slot is shared by overflow threads
+ * (*shared set), everything else has exactly one writer */
+static inline timer_histogram_t *timer_histogram_shard(timer_histogram_set_t *set, int *shared) {
+    uint64_t slot = timer_thread_slot();
+    *shared = slot == TIMER_HIST_MAX_THREADS;
+    
+    uint64_t shard = timer_atomic_load(&set->shards[slot]);
+    if (shard == 0) {
+        timer_histogram_t *h = (timer_histogram_t *)calloc(1, sizeof(timer_histogram_t));
+        if (!h) return NULL;
+        if (!timer_atomic_cas(&set->shards[slot], &shard, (uint64_t)(uintptr_t)h)) {
+            free(h);  /* another overflow thread won */
+        } else {
+            shard = (uint64_t)(uintptr_t)h;
+        }
+    }
+    return (timer_histogram_t *)(uintptr_t)shard;
+}
+
+/* Record into the calling thread's shard (the first record per thread allocates it) */
+static inline void timer_histogram_set_record(timer_histogram_set_t *set, uint64_t ns) {
+    int shared;
+    timer_histogram_t *h = timer_histogram_shard(set, &shared);
+    if (!h) return;
+    if (shared) timer_histogram_record_atomic(h, ns);
+    else timer_histogram_record(h, ns);
+}
+
+/*
+ * Merge every shard into out (overwritten): counts since the last reset.
+ * With reset, the current counts become the new baseline, so the next
+ * snapshot only sees what was recorded after this one; writers are never
+ * stopped or zeroed. After a reset min/max come from the buckets. One
+ * reader at a time. Returns false if the baseline can't be allocated.
+ */
+static inline int timer_histogram_set_snapshot(timer_histogram_set_t *set, timer_histogram_t *out, int reset) {
+    timer_histogram_reset(out);
+    for (int i = 0; i <= TIMER_HIST_MAX_THREADS; i++) {
+        uint64_t shard = timer_atomic_load(&set->shards[i]);
+        if (shard) timer_histogram_merge(out, (timer_histogram_t *)(uintptr_t)shard);
+    }
+    
+    timer_histogram_t *base = set->baseline;
+    if (!base && reset) {
+        base = (timer_histogram_t *)calloc(1, sizeof(timer_histogram_t));
+        if (!base) return 0;
+        set->baseline = base;
+    }
+    if (!base) return 1;
+    
+    uint64_t total = 0, lowest = 0, highest = 0;
+    for (uint32_t i = 0; i < TIMER_HIST_BUCKETS; i++) {
+        uint64_t count = out->counts[i];
+        out->counts[i] = count - base->counts[i];
+        if (reset) base->counts[i] = count;
+        if (out->counts[i]) {
+            if (total == 0) lowest = timer_histogram_lowest(i);
+            highest = timer_histogram_highest(i);
+            total += out->counts[i];
+        }
+    }
+    uint64_t sum_ns = out->sum_ns;
+    out->sum_ns = sum_ns - base->sum_ns;
+    if (reset) base->sum_ns = sum_ns;
+    
+    /* Recorded min/max may predate the baseline; use bucket bounds */
+    out->min_inv = total ? ~lowest : 0;
+    out->max_ns = total ? (out->max_ns < highest ? out->max_ns : highest) : 0;
+    out->total = total;
+    return 1;
+}
+
+/* Percentile summary on one line */
+static inline void timer_histogram_print(const timer_histogram_t *h, const char *label) {
+    char min[32], p50[32], p90[32], p99[32], p999[32], max[32];
+    if (label == NULL) label = "Histogram";
+    printf("%s: %llu samples, min %s, p50 %s, p90 %s, p99 %s, p99.9 %s, max %s\n",
+           label, (unsigned long long)h->total,
+           benchmark_format_ns((double)timer_histogram_min(h), min, sizeof(min)),
+           benchmark_format_ns((double)timer_histogram_percentile(h, 50.0), p50, sizeof(p50)),
+           benchmark_format_ns((double)timer_histogram_percentile(h, 90.0), p90, sizeof(p90)),
+           benchmark_format_ns((double)timer_histogram_percentile(h, 99.0), p99, sizeof(p99)),
+           benchmark_format_ns((double)timer_histogram_percentile(h, 99.9), p999, sizeof(p999)),
+           benchmark_format_ns((double)timer_histogram_max(h), max, sizeof(max)));
+}
+
+/* Like TIMER_STOP_AND_PRINT / TIME_BLOCK / TIME_FUNCTION, but record the
+ * elapsed ns into a histogram set instead of printing */
+#define TIMER_STOP_AND_RECORD(name, hist) \
+    timer_stop(&name); \
+    timer_histogram_set_record(&(hist), timer_elapsed_ns(&name))
+
+#define TIME_BLOCK_HIST(hist, code) \
+    do { \
+        TIMER_START(__timer); \
+        code; \
+        TIMER_STOP_AND_RECORD(__timer, hist); \
+    } while(0)
+
+#define TIME_FUNCTION_HIST(func_call, hist) \
+    do { \
+        TIMER_START(__timer); \
+        func_call; \
+        TIMER_STOP_AND_RECORD(__timer, hist); \
+    } while(0)
+
+/*
+ * Profiling zones. TIMER_ZONE_BEGIN/END (or TIME_ZONE, or the scoped
+ * TIMER_ZONE on GCC/Clang) push a 16-byte begin/end event (raw counter
+ * ticks, zone id) into the calling thread's ring: no locks, no formatting,
+ * and a single load and branch while tracing is off. Rings keep the newest
+ * TIMER_TRACE_RING_EVENTS events. timer_trace_write_json pairs begins with
+ * ends per thread and writes Chrome trace JSON (chrome://tracing, Perfetto
+ * UI); stop tracing first for an exact capture. Zone names must outlive the
+ * trace (string literals). -DTIMER_NO_TRACE compiles the macros out.
+ * A thread's ring passes to the next new thread once it exits; threads past
+ * TIMER_HIST_MAX_THREADS alive at once don't trace (timer_trace_dropped).
+ */
+
+typedef struct {
+    uint64_t ticks;
+    uint32_t zone;      /* 0 on end events */
+    uint32_t phase;     /* TIMER_TRACE_BEGIN / TIMER_TRACE_END */
+} timer_trace_event_t;
+
+/* RESTART: the ring changed owner; zones still open belong to the old one */
+enum { TIMER_TRACE_BEGIN = 1, TIMER_TRACE_END = 2, TIMER_TRACE_RESTART = 3 };
+
+typedef struct {
+    volatile uint64_t head;     /* events ever written */
+    const char *thread_name;
+    timer_trace_event_t events[TIMER_TRACE_RING_EVENTS];
+} timer_trace_ring_t;
+
+static volatile uint64_t g_timer_trace_enabled = 0;
+static volatile uint64_t g_timer_trace_rings[TIMER_HIST_MAX_THREADS];
+static const char *volatile g_timer_zone_names[TIMER_TRACE_MAX_ZONES + 1] = {"(too many zones)"};
+static volatile uint64_t g_timer_zone_count = 0;
+static volatile uint64_t g_timer_trace_dropped = 0;
+
+/* Turning tracing on calibrates the clock, so the hot path never does */
+static inline void timer_trace_enable(int enabled) {
+    if (enabled) timer_clock_init();
+    timer_atomic_store(&g_timer_trace_enabled, enabled ? 1 : 0);
+}
+
+static inline int timer_trace_enabled(void) {
+    return timer_atomic_load(&g_timer_trace_enabled) != 0;
+}
+
+/* Id for a zone name; the macros call this once per call site */
+static inline uint32_t timer_zone_register(const char *name) {
+    uint64_t id = timer_atomic_fetch_add(&g_timer_zone_count, 1) + 1;
+    if (id > TIMER_TRACE_MAX_ZONES) return 0;
+    g_timer_zone_names[id] = name;
+    return (uint32_t)id;
+}
+
+static inline void timer_trace_push_event(timer_trace_ring_t *ring, uint32_t zone, uint32_t phase) {
+    uint64_t head = ring->head;
+    timer_trace_event_t *e = &ring->events[head & (TIMER_TRACE_RING_EVENTS - 1)];
+    e->ticks = timer_read_ticks_raw();
+    e->zone = zone;
+    e->phase = phase;
+    timer_atomic_store(&ring->head, head + 1);
+}
+
+/* The calling thread's ring, allocated on its first event; NULL when every
+ * slot is taken by a live thread. A ring left by an exited thread is taken
+ * over: its events stay, the name resets and a restart event closes its
+ * zones off */
+static inline timer_trace_ring_t *timer_trace_ring(void) {
+    uint64_t slot = timer_thread_slot();
+    if (slot >= TIMER_HIST_MAX_THREADS) return NULL;
+    timer_trace_ring_t *ring = (timer_trace_ring_t *)(uintptr_t)g_timer_trace_rings[slot];
+    if (!ring) {
+        ring = (timer_trace_ring_t *)calloc(1, sizeof(timer_trace_ring_t));
+        if (ring) timer_atomic_store(&g_timer_trace_rings[slot], (uint64_t)(uintptr_t)ring);
+    } else if (t_timer_slot_fresh) {
+        ring->thread_name = NULL;
+        if (ring->head) timer_trace_push_event(ring, 0, TIMER_TRACE_RESTART);
+    }
+    t_timer_slot_fresh = 0;
+    return ring;
+}
+
+/* Label the calling thread in exported traces (defaults to "thread N") */
+static inline void timer_trace_thread_name(const char *name) {
+    timer_trace_ring_t *ring = timer_trace_ring();
+    if (ring) ring->thread_name = name;
+}
+
+static inline void timer_trace_push(uint32_t zone, uint32_t phase) {
+    timer_trace_ring_t *ring = timer_trace_ring();
+    if (!ring) {
+        timer_atomic_fetch_add(&g_timer_trace_dropped, 1);
+        return;
+    }
+    timer_trace_push_event(ring, zone, phase);
+}
+
+/* Events lost because their thread had no ring (more than
+ * TIMER_HIST_MAX_THREADS threads alive, or the ring couldn't be allocated) */
+static inline uint64_t timer_trace_dropped(void) {
+    return timer_atomic_load(&g_timer_trace_dropped);
+}
+
+static inline void timer_zone_begin(volatile uint64_t *site, const char *name) {
+    if (!timer_atomic_load(&g_timer_trace_enabled)) return;
+    /* Bit 32 marks the site registered, even as the overflow id 0; a racing
+     * first call just registers the name twice */
+    uint64_t id = timer_atomic_load(site);
+    if (!id) {
+        id = timer_zone_register(name) | (1ULL << 32);
+        timer_atomic_store(site, id);
+    }
+    timer_trace_push((uint32_t)id, TIMER_TRACE_BEGIN);
+}
+
+static inline void timer_zone_end(void) {
+    if (!timer_atomic_load(&g_timer_trace_enabled)) return;
+    timer_trace_push(0, TIMER_TRACE_END);
+}
+
+/* Drop all recorded events (while tracing is off) */
+static inline void timer_trace_reset(void) {
+    for (int i = 0; i < TIMER_HIST_MAX_THREADS; i++) {
+        timer_trace_ring_t *ring = (timer_trace_ring_t *)(uintptr_t)timer_atomic_load(&g_timer_trace_rings[i]);
+        if (ring) timer_atomic_store(&ring->head, 0);
+    }
+    timer_atomic_store(&g_timer_trace_dropped, 0);
+}
+
+/* Zones begun but never ended, as "B" events */
+static inline size_t timer_trace_write_open(FILE *out, const char **sep, unsigned long pid, int tid,
+                                            const timer_trace_event_t *stack, int depth, uint64_t epoch) {
+    for (int d = 0; d < depth; d++) {
+        const char *name = g_timer_zone_names[stack[d].zone <= TIMER_TRACE_MAX_ZONES ? stack[d].zone : 0];
+        fprintf(out, "%s  {\"ph\": \"B\", \"name\": ", *sep);
+        benchmark_write_json_string(out, name ? name : "?");
+        fprintf(out, ", \"pid\": %lu, \"tid\": %d, \"ts\": %.3f}",
+                pid, tid, timer_ticks_to_ns(stack[d].ticks - epoch) / 1000.0);
+        *sep = ",\n";
+    }
+    return (size_t)depth;
+}
+
+/*
+ * {"traceEvents": [...]}: one "X" (complete) event per matched begin/end,
+ * "B" for zones still open, thread_name metadata per ring. Ends whose begin
+ * was overwritten (or predates enabling) are skipped. Timestamps are us
+ * since the earliest retained event. Returns the number of zones written.
+ */
+static inline size_t timer_trace_write_json(FILE *out) {
+    timer_clock_init();
+#ifdef _WIN32
+    unsigned long pid = (unsigned long)GetCurrentProcessId();
+#else
+    unsigned long pid = (unsigned long)getpid();
+#endif
+    
+    uint64_t epoch = UINT64_MAX;
+    for (int i = 0; i < TIMER_HIST_MAX_THREADS; i++) {
+        timer_trace_ring_t *ring = (timer_trace_ring_t *)(uintptr_t)timer_atomic_load(&g_timer_trace_rings[i]);
+        if (!ring) continue;
+        uint64_t head = timer_atomic_load(&ring->head);
+        uint64_t first = head > TIMER_TRACE_RING_EVENTS ? head - TIMER_TRACE_RING_EVENTS : 0;
+        if (head > first) {
+            uint64_t ticks = ring->events[first & (TIMER_TRACE_RING_EVENTS - 1)].ticks;
+            if (ticks < epoch) epoch = ticks;
+        }
+    }
+    
+    size_t written = 0;
+    const char *sep = "\n";
+    fprintf(out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+    for (int i = 0; i < TIMER_HIST_MAX_THREADS; i++) {
+        timer_trace_ring_t *ring = (timer_trace_ring_t *)(uintptr_t)timer_atomic_load(&g_timer_trace_rings[i]);
+        if (!ring) continue;
+        
+        fprintf(out, "%s  {\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": %lu, \"tid\": %d, \"args\": {\"name\": ",
+                sep, pid, i + 1);
+        if (ring->thread_name) {
+            benchmark_write_json_string(out, ring->thread_name);
+        } else {
+            fprintf(out, "\"thread %d\"", i + 1);
+        }
+        fprintf(out, "}}");
+        sep = ",\n";
+        
+        timer_trace_event_t stack[TIMER_TRACE_MAX_DEPTH];
+        int depth = 0, skipped = 0;
+        uint64_t head = timer_atomic_load(&ring->head);
+        uint64_t first = head > TIMER_TRACE_RING_EVENTS ? head - TIMER_TRACE_RING_EVENTS : 0;
+        for (uint64_t n = first; n < head; n++) {
+            timer_trace_event_t e = ring->events[n & (TIMER_TRACE_RING_EVENTS - 1)];
+            if (e.phase == TIMER_TRACE_RESTART) {
+                written += timer_trace_write_open(out, &sep, pid, i + 1, stack, depth, epoch);
+                depth = 0;
+                skipped = 0;
+                continue;
+            }
+            if (e.phase == TIMER_TRACE_BEGIN) {
+                /* Too deep: count it so its end is dropped too */
+                if (depth < TIMER_TRACE_MAX_DEPTH) stack[depth++] = e;
+                else skipped++;
+                continue;
+            }
+            if (skipped) { skipped--; continue; }
+            if (depth == 0) continue;
+            timer_trace_event_t b = stack[--depth];
+            const char *name = g_timer_zone_names[b.zone <= TIMER_TRACE_MAX_ZONES ? b.zone : 0];
+            fprintf(out, "%s  {\"ph\": \"X\", \"name\": ", sep);
+            benchmark_write_json_string(out, name ? name : "?");
+            fprintf(out, ", \"pid\": %lu, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                    pid, i + 1,
+                    timer_ticks_to_ns(b.ticks - epoch) / 1000.0,
+                    timer_ticks_to_ns(e.ticks - b.ticks) / 1000.0);
+            written++;
+        }
+        written += timer_trace_write_open(out, &sep, pid, i + 1, stack, depth, epoch);
+    }
+    fprintf(out, "\n]}\n");
+    return written;
+}
+
+/* timer_trace_write_json to a file; false if it can't be opened */
+static inline int timer_trace_write_file(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) return 0;
+    timer_trace_write_json(out);
+    return fclose(out) == 0;
+}
+
+#ifndef TIMER_NO_TRACE
+    #define TIMER_ZONE_BEGIN(name) \
+        do { \
+            static volatile uint64_t __timer_zone = 0; \
+            timer_zone_begin(&__timer_zone, name); \
+        } while(0)
+    
+    #define TIMER_ZONE_END() timer_zone_end()
+    
+    #define TIME_ZONE(name, code) \
+        do { \
+            TIMER_ZONE_BEGIN(name); \
+            code; \
+            TIMER_ZONE_END(); \
+        } while(0)
+    
+    /* Zone lasting until the end of the enclosing scope */
+    #if defined(__GNUC__) || defined(__clang__)
+        static inline void timer_zone_cleanup(int *scope) { (void)scope; timer_zone_end(); }
+        #define TIMER_ZONE_CONCAT_(a, b) a##b
+        #define TIMER_ZONE_CONCAT(a, b) TIMER_ZONE_CONCAT_(a, b)
+        #define TIMER_ZONE(name) \
+            TIMER_ZONE_BEGIN(name); \
+            int TIMER_ZONE_CONCAT(__timer_zone_scope_, __LINE__) __attribute__((cleanup(timer_zone_cleanup), unused)) = 0
+    #endif
+#else
+    #define TIMER_ZONE_BEGIN(name) ((void)0)
+    #define TIMER_ZONE_END() ((void)0)
+    #define TIME_ZONE(name, code) do { code; } while(0)
+    #if defined(__GNUC__) || defined(__clang__)
+        #define TIMER_ZONE(name) ((void)0)
+    #endif
+#endif
+
+/* Sleep functions for precise delays */
+static inline void sleep_ns(uint64_t nanoseconds) {
+#ifdef _WIN32
+    /* Windows doesn't have nanosecond precision sleep, use microseconds */
+    if (nanoseconds >= 1000) {
+        Sleep((DWORD)(nanoseconds / 1000000));
+    }
+#else
+    struct timespec ts;
+    ts.tv_sec = nanoseconds / 1000000000ULL;
+    ts.tv_nsec = nanoseconds % 1000000000ULL;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static inline void sleep_us(uint64_t microseconds) {
+    sleep_ns(microseconds * 1000);
+}
+
+static inline void sleep_ms(uint64_t milliseconds) {
+    sleep_ns(milliseconds * 1000000);
+}
+
 #endif /* TIMING_H */
\ No newline at end of file